@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+
+/*
+ * GPIO dispatch microbenchmark
+ *
+ * Registers an increasing number of GPIO callbacks, up to
+ * CONFIG_OCRE_GPIO_MAX_PORTS * CONFIG_OCRE_GPIO_PINS_PER_PORT, and measures the
+ * cost of gpio_callback() for the most recently registered pin. The host imports
+ * used by the SDK are stubbed so the benchmark runs under any WASI runtime, unlike
+ * ocre_bench, which needs the native runtime emulation.
+ */
+#include "ocre_api.h"
+#include <stdio.h>
+#include <time.h>
+
+#define ITERATIONS 100000
+#define TOTAL_PINS (CONFIG_OCRE_GPIO_MAX_PORTS * CONFIG_OCRE_GPIO_PINS_PER_PORT)
+
+void gpio_callback(int pin, int state, int port);
+
+// Host stubs
+int ocre_register_dispatcher(ocre_resource_type_t type, const char *function_name) { return OCRE_SUCCESS; }
+int ocre_register_event_ring(ocre_event_ring_t *ring, uint32_t capacity) { return OCRE_ERROR_NOT_FOUND; }
+int ocre_get_event(uintptr_t type_offset, uintptr_t id_offset, uintptr_t port_offset, uintptr_t state_offset) { return OCRE_ERROR_NOT_FOUND; }
+int ocre_wait_events(int timeout_ms) { return OCRE_ERROR_TIMEOUT; }
+int ocre_sleep(int milliseconds) { return OCRE_SUCCESS; }
+int ocre_time_page_register(ocre_time_page_t *page) { return OCRE_ERROR_NOT_FOUND; }
+int ocre_timer_create(int id) { return OCRE_SUCCESS; }
+int ocre_timer_start(int id, int interval, int is_periodic) { return OCRE_SUCCESS; }
+int ocre_timer_stop(int id) { return OCRE_SUCCESS; }
+int ocre_timer_get_remaining(int id) { return 0; }
+int ocre_subscribe_message(char *topic, char *handler_name) { return OCRE_SUCCESS; }
+int ocre_unsubscribe_message(char *topic, char *handler_name) { return OCRE_SUCCESS; }
+int ocre_release_message(uint32_t mid) { return OCRE_ERROR_NOT_FOUND; }
+
+static volatile uint32_t callback_hits;
+
+static void on_gpio(void)
+{
+    callback_hits++;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+int main(void)
+{
+    int registered = 0;
+
+    printf("%10s %14s\n", "callbacks", "ns/dispatch");
+
+    for (int target = 1; target <= TOTAL_PINS; target *= 2)
+    {
+        // Spread registrations across ports so the last pin sits in the last used port
+        while (registered < target)
+        {
+            int port = registered / CONFIG_OCRE_GPIO_PINS_PER_PORT;
+            int pin = registered % CONFIG_OCRE_GPIO_PINS_PER_PORT;
+            ocre_register_gpio_callback(pin, port, on_gpio);
+            registered++;
+        }
+
+        int last_port = (registered - 1) / CONFIG_OCRE_GPIO_PINS_PER_PORT;
+        int last_pin = (registered - 1) % CONFIG_OCRE_GPIO_PINS_PER_PORT;
+
+        uint64_t start = now_ns();
+        for (int i = 0; i < ITERATIONS; i++)
+        {
+            gpio_callback(last_pin, i & 1, last_port);
+        }
+        uint64_t elapsed = now_ns() - start;
+
+        printf("%10d %14.1f\n", registered, (double)elapsed / ITERATIONS);
+    }
+
+    return callback_hits == 0;
+}
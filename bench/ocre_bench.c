@@ -0,0 +1,571 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+
+/*
+ * SDK benchmark suite
+ *
+ * Runs natively against the emulated runtime in native/ and measures:
+ *   - ocre_process_events throughput and post-to-callback latency at several queue depths
+ *   - timer_callback and gpio_callback dispatch cost with 1 to N registered callbacks
+ *   - ocre_publish_message cost across payload sizes up to OCRE_MAX_PAYLOAD_LEN
+ *   - ocre_channel_send plus ocre_channel_recv cost per message across the same sizes
+ *   - GPIO input edge cost delivered as one event per edge versus batched through edge capture
+ *   - ocre_register_*_callback cost
+ *
+ * Results are written as JSON, one result object per line. Two result files can be
+ * compared with --compare; a benchmark whose ns_per_op grew by more than the threshold
+ * percentage and by at least the minimum delta is reported as a regression and the exit
+ * status is 1. The minimum delta keeps timer noise on nanosecond-scale paths from being
+ * flagged.
+ *
+ *   ocre_bench [--iterations N] [--output FILE]
+ *   ocre_bench --compare BASE.json NEW.json [--threshold PERCENT] [--min-delta NS]
+ */
+#include "ocre_native.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_ITERATIONS 100000
+#define DEFAULT_THRESHOLD_PCT 10.0
+#define DEFAULT_MIN_DELTA_NS 1.0
+#define REPEATS 5 // Each benchmark reports the best of this many runs
+#define MAX_RESULTS 64
+#define MAX_DEPTH 256
+#define BENCH_TOPIC "bench/payload"
+#define BENCH_CHANNEL_DEPTH 64
+#define BENCH_CHANNEL_BATCH 32
+#define BENCH_EDGE_BATCH 32
+#define BENCH_EDGE_PORT 0
+#define BENCH_EDGE_PIN 0
+
+#define TOTAL_PINS (CONFIG_OCRE_GPIO_MAX_PORTS * CONFIG_OCRE_GPIO_PINS_PER_PORT)
+
+void timer_callback(int timer_id);
+void gpio_callback(int pin, int state, int port);
+
+typedef struct
+{
+    char name[64];
+    double ns_per_op;
+    double latency_ns; // Mean post-to-callback latency, 0 when not measured
+    long ops;
+} bench_result_t;
+
+static bench_result_t results[MAX_RESULTS];
+static int result_count = 0;
+static int iterations = DEFAULT_ITERATIONS;
+
+static volatile uint32_t callback_hits;
+static uint64_t post_ns[MAX_DEPTH];
+static uint64_t latency_total_ns;
+
+static void record(const char *name, double ns_per_op, double latency_ns, long ops)
+{
+    if (result_count >= MAX_RESULTS)
+    {
+        return;
+    }
+
+    bench_result_t *result = &results[result_count++];
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    result->ns_per_op = ns_per_op;
+    result->latency_ns = latency_ns;
+    result->ops = ops;
+    fprintf(stderr, "%-36s %12.1f ns/op\n", name, ns_per_op);
+}
+
+static void on_callback(void)
+{
+    callback_hits++;
+}
+
+static void on_event(void)
+{
+    latency_total_ns += ocre_native_time_ns() - post_ns[callback_hits % MAX_DEPTH];
+    callback_hits++;
+}
+
+OCRE_EXPORT("bench_msg_handler") void bench_msg_handler(ocre_msg_t *msg)
+{
+    callback_hits++;
+}
+
+// =============================================================================
+// BENCHMARKS
+// =============================================================================
+
+static void bench_process_events(void)
+{
+    static const int depths[] = {1, 8, 32, 128};
+
+    ocre_event_ring_enable();
+    ocre_register_gpio_callback(0, 0, on_event);
+
+    for (size_t d = 0; d < sizeof(depths) / sizeof(depths[0]); d++)
+    {
+        int depth = depths[d];
+        int rounds = iterations / depth > 0 ? iterations / depth : 1;
+        double best_ns = 0;
+        double best_latency = 0;
+
+        for (int repeat = 0; repeat < REPEATS; repeat++)
+        {
+            uint64_t elapsed = 0;
+            callback_hits = 0;
+            latency_total_ns = 0;
+
+            for (int round = 0; round < rounds; round++)
+            {
+                // Queue a burst, then drain it; only the draining is timed
+                for (int i = 0; i < depth; i++)
+                {
+                    post_ns[(callback_hits + i) % MAX_DEPTH] = ocre_native_time_ns();
+                    ocre_native_post_event(OCRE_RESOURCE_TYPE_GPIO, 0, 0, i & 1);
+                }
+
+                uint64_t start = ocre_native_time_ns();
+                while (ocre_native_pending_events() > 0)
+                {
+                    ocre_process_events();
+                }
+                elapsed += ocre_native_time_ns() - start;
+            }
+
+            double ns = (double)elapsed / ((double)rounds * depth);
+            if (repeat == 0 || ns < best_ns)
+            {
+                best_ns = ns;
+                best_latency = (double)latency_total_ns / callback_hits;
+            }
+        }
+
+        char name[64];
+        snprintf(name, sizeof(name), "process_events/depth=%d", depth);
+        record(name, best_ns, best_latency, (long)rounds * depth);
+    }
+
+    ocre_unregister_gpio_callback(0, 0);
+}
+
+static void bench_timer_dispatch(void)
+{
+    int registered = 0;
+
+    for (int target = 1; target <= OCRE_MAX_TIMERS; target *= 2)
+    {
+        while (registered < target)
+        {
+            ocre_register_timer_callback(++registered, on_callback);
+        }
+
+        double best_ns = 0;
+        for (int repeat = 0; repeat < REPEATS; repeat++)
+        {
+            uint64_t start = ocre_native_time_ns();
+            for (int i = 0; i < iterations; i++)
+            {
+                timer_callback(registered);
+            }
+            double ns = (double)(ocre_native_time_ns() - start) / iterations;
+            best_ns = (repeat == 0 || ns < best_ns) ? ns : best_ns;
+        }
+
+        char name[64];
+        snprintf(name, sizeof(name), "timer_dispatch/callbacks=%d", registered);
+        record(name, best_ns, 0, iterations);
+    }
+
+    for (int id = 1; id <= registered; id++)
+    {
+        ocre_unregister_timer_callback(id);
+    }
+}
+
+static void bench_gpio_dispatch(void)
+{
+    int registered = 0;
+
+    for (int target = 1; target <= TOTAL_PINS; target *= 2)
+    {
+        // Spread registrations across ports so the last pin sits in the last used port
+        while (registered < target)
+        {
+            ocre_register_gpio_callback(registered % CONFIG_OCRE_GPIO_PINS_PER_PORT,
+                                        registered / CONFIG_OCRE_GPIO_PINS_PER_PORT, on_callback);
+            registered++;
+        }
+
+        int last_port = (registered - 1) / CONFIG_OCRE_GPIO_PINS_PER_PORT;
+        int last_pin = (registered - 1) % CONFIG_OCRE_GPIO_PINS_PER_PORT;
+
+        double best_ns = 0;
+        for (int repeat = 0; repeat < REPEATS; repeat++)
+        {
+            uint64_t start = ocre_native_time_ns();
+            for (int i = 0; i < iterations; i++)
+            {
+                gpio_callback(last_pin, i & 1, last_port);
+            }
+            double ns = (double)(ocre_native_time_ns() - start) / iterations;
+            best_ns = (repeat == 0 || ns < best_ns) ? ns : best_ns;
+        }
+
+        char name[64];
+        snprintf(name, sizeof(name), "gpio_dispatch/callbacks=%d", registered);
+        record(name, best_ns, 0, iterations);
+    }
+
+    for (int i = 0; i < registered; i++)
+    {
+        ocre_unregister_gpio_callback(i % CONFIG_OCRE_GPIO_PINS_PER_PORT, i / CONFIG_OCRE_GPIO_PINS_PER_PORT);
+    }
+}
+
+static void bench_publish(void)
+{
+    static uint8_t payload[OCRE_MAX_PAYLOAD_LEN];
+
+    if (ocre_subscribe_message(BENCH_TOPIC, "bench_msg_handler") != OCRE_SUCCESS)
+    {
+        fprintf(stderr, "Failed to subscribe benchmark handler\n");
+        return;
+    }
+
+    for (int size = 0; size <= OCRE_MAX_PAYLOAD_LEN; size = size ? size * 4 : 16)
+    {
+        double best_ns = 0;
+        for (int repeat = 0; repeat < REPEATS; repeat++)
+        {
+            uint64_t start = ocre_native_time_ns();
+            for (int i = 0; i < iterations; i++)
+            {
+                ocre_publish_message(BENCH_TOPIC, "application/octet-stream", payload, size);
+            }
+            double ns = (double)(ocre_native_time_ns() - start) / iterations;
+            best_ns = (repeat == 0 || ns < best_ns) ? ns : best_ns;
+        }
+
+        char name[64];
+        snprintf(name, sizeof(name), "publish/payload=%d", size);
+        record(name, best_ns, 0, iterations);
+    }
+}
+
+static void on_handler(const event_data_t *event, void *user_ctx)
+{
+    callback_hits++;
+}
+
+static void bench_channel(void)
+{
+    static uint8_t payload[OCRE_MAX_PAYLOAD_LEN];
+    ocre_channel_t producer;
+    ocre_channel_t consumer;
+
+    int ret = ocre_channel_open(&producer, "bench", OCRE_CHANNEL_PRODUCER, BENCH_CHANNEL_DEPTH, OCRE_MAX_PAYLOAD_LEN);
+    if (ret == OCRE_SUCCESS)
+    {
+        ret = ocre_channel_open(&consumer, "bench", OCRE_CHANNEL_CONSUMER, BENCH_CHANNEL_DEPTH, OCRE_MAX_PAYLOAD_LEN);
+    }
+    if (ret == OCRE_SUCCESS)
+    {
+        ret = ocre_register_event_handler(OCRE_RESOURCE_TYPE_CHANNEL, consumer.id, 0, on_handler, NULL);
+    }
+    if (ret != OCRE_SUCCESS)
+    {
+        fprintf(stderr, "Failed to open benchmark channel\n");
+        return;
+    }
+
+    // Messages go through in batches, so each batch costs one consumer wakeup
+    int batches = (iterations + BENCH_CHANNEL_BATCH - 1) / BENCH_CHANNEL_BATCH;
+    for (int size = 16; size <= OCRE_MAX_PAYLOAD_LEN; size *= 4)
+    {
+        double best_ns = 0;
+        for (int repeat = 0; repeat < REPEATS; repeat++)
+        {
+            uint64_t start = ocre_native_time_ns();
+            for (int batch = 0; batch < batches; batch++)
+            {
+                for (int i = 0; i < BENCH_CHANNEL_BATCH; i++)
+                {
+                    ocre_channel_send(&producer, payload, (uint32_t)size);
+                }
+                while (ocre_channel_recv(&consumer, payload, sizeof(payload)) >= 0)
+                {
+                }
+            }
+            double ns = (double)(ocre_native_time_ns() - start) / (batches * BENCH_CHANNEL_BATCH);
+            best_ns = (repeat == 0 || ns < best_ns) ? ns : best_ns;
+            ocre_process_events_ex(0, 0, NULL); // Drain the wakeup events
+        }
+
+        char name[64];
+        snprintf(name, sizeof(name), "channel/payload=%d", size);
+        record(name, best_ns, 0, (long)batches * BENCH_CHANNEL_BATCH);
+    }
+
+    ocre_unregister_event_handler(OCRE_RESOURCE_TYPE_CHANNEL, consumer.id, 0);
+    ocre_channel_close(&producer);
+    ocre_channel_close(&consumer);
+}
+
+// Drive BENCH_EDGE_BATCH edges per loop pass and handle them; returns the best ns per edge
+static double bench_edges(ocre_gpio_capture_t *capture)
+{
+    int batches = (iterations + BENCH_EDGE_BATCH - 1) / BENCH_EDGE_BATCH;
+    ocre_gpio_pulse_t pulse;
+    double best_ns = 0;
+
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        ocre_gpio_pulse_reset(&pulse);
+        uint64_t start = ocre_native_time_ns();
+        for (int batch = 0; batch < batches; batch++)
+        {
+            for (int i = 0; i < BENCH_EDGE_BATCH; i++)
+            {
+                ocre_native_gpio_input(BENCH_EDGE_PORT, BENCH_EDGE_PIN, !(i & 1));
+            }
+            ocre_process_events_ex(0, 0, NULL);
+            if (capture)
+            {
+                ocre_gpio_pulse_update(capture, &pulse, NULL, 0);
+            }
+        }
+        double ns = (double)(ocre_native_time_ns() - start) / (batches * BENCH_EDGE_BATCH);
+        best_ns = (repeat == 0 || ns < best_ns) ? ns : best_ns;
+    }
+    return best_ns;
+}
+
+static void bench_gpio_edges(void)
+{
+    static ocre_gpio_capture_t capture;
+    long ops = (long)((iterations + BENCH_EDGE_BATCH - 1) / BENCH_EDGE_BATCH) * BENCH_EDGE_BATCH;
+
+    ocre_gpio_configure(BENCH_EDGE_PORT, BENCH_EDGE_PIN, OCRE_GPIO_DIR_INPUT);
+    ocre_gpio_register_callback(BENCH_EDGE_PORT, BENCH_EDGE_PIN);
+    ocre_register_event_handler(OCRE_RESOURCE_TYPE_GPIO, BENCH_EDGE_PIN, BENCH_EDGE_PORT, on_handler, NULL);
+    record("gpio_edges/mode=event", bench_edges(NULL), 0, ops);
+    ocre_unregister_event_handler(OCRE_RESOURCE_TYPE_GPIO, BENCH_EDGE_PIN, BENCH_EDGE_PORT);
+    ocre_gpio_unregister_callback(BENCH_EDGE_PORT, BENCH_EDGE_PIN);
+
+    if (ocre_gpio_capture_open(&capture, BENCH_EDGE_PORT, BENCH_EDGE_PIN, OCRE_GPIO_EDGE_BOTH, BENCH_EDGE_BATCH,
+                               0) != OCRE_SUCCESS)
+    {
+        fprintf(stderr, "Failed to open benchmark capture\n");
+        return;
+    }
+    ocre_register_event_handler(OCRE_RESOURCE_TYPE_GPIO_CAPTURE, capture.id, 0, on_handler, NULL);
+    record("gpio_edges/mode=capture", bench_edges(&capture), 0, ops);
+    ocre_unregister_event_handler(OCRE_RESOURCE_TYPE_GPIO_CAPTURE, capture.id, 0);
+    ocre_gpio_capture_close(&capture);
+}
+
+static void bench_register(void)
+{
+    static const char *names[] = {"register/timer", "register/gpio", "register/sensor"};
+
+    for (int kind = 0; kind < 3; kind++)
+    {
+        double best_ns = 0;
+        for (int repeat = 0; repeat < REPEATS; repeat++)
+        {
+            uint64_t start = ocre_native_time_ns();
+            for (int i = 0; i < iterations; i++)
+            {
+                switch (kind)
+                {
+                case 0:
+                    ocre_register_timer_callback(1 + i % OCRE_MAX_TIMERS, on_callback);
+                    break;
+                case 1:
+                    ocre_register_gpio_callback(i % CONFIG_OCRE_GPIO_PINS_PER_PORT, 0, on_callback);
+                    break;
+                default:
+                    ocre_register_sensor_callback(i % OCRE_MAX_SENSORS, on_callback);
+                    break;
+                }
+            }
+            double ns = (double)(ocre_native_time_ns() - start) / iterations;
+            best_ns = (repeat == 0 || ns < best_ns) ? ns : best_ns;
+        }
+        record(names[kind], best_ns, 0, iterations);
+    }
+}
+
+// =============================================================================
+// OUTPUT AND COMPARISON
+// =============================================================================
+
+static void write_results(FILE *out)
+{
+    fprintf(out, "{\n  \"suite\": \"ocre_bench\",\n  \"sdk_version\": \"%s\",\n  \"iterations\": %d,\n",
+            OCRE_SDK_VERSION, iterations);
+    fprintf(out, "  \"results\": [\n");
+    for (int i = 0; i < result_count; i++)
+    {
+        fprintf(out, "    {\"name\": \"%s\", \"ns_per_op\": %.2f, \"latency_ns\": %.2f, \"ops\": %ld}%s\n",
+                results[i].name, results[i].ns_per_op, results[i].latency_ns, results[i].ops,
+                i + 1 < result_count ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+// Read the result lines written by write_results
+static int load_results(const char *path, bench_result_t *loaded, int max_results)
+{
+    FILE *in = fopen(path, "r");
+    if (in == NULL)
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return -1;
+    }
+
+    char line[256];
+    int count = 0;
+    while (count < max_results && fgets(line, sizeof(line), in))
+    {
+        bench_result_t *result = &loaded[count];
+        if (sscanf(line, " {\"name\": \"%63[^\"]\", \"ns_per_op\": %lf, \"latency_ns\": %lf, \"ops\": %ld",
+                   result->name, &result->ns_per_op, &result->latency_ns, &result->ops) == 4)
+        {
+            count++;
+        }
+    }
+
+    fclose(in);
+    return count;
+}
+
+static int compare(const char *base_path, const char *new_path, double threshold_pct, double min_delta_ns)
+{
+    static bench_result_t base[MAX_RESULTS];
+    static bench_result_t current[MAX_RESULTS];
+
+    int base_count = load_results(base_path, base, MAX_RESULTS);
+    int current_count = load_results(new_path, current, MAX_RESULTS);
+    if (base_count < 0 || current_count < 0)
+    {
+        return 2;
+    }
+
+    int regressions = 0;
+    bool first = true;
+
+    printf("{\n  \"threshold_pct\": %.1f,\n  \"min_delta_ns\": %.1f,\n  \"results\": [\n", threshold_pct,
+           min_delta_ns);
+    for (int i = 0; i < current_count; i++)
+    {
+        for (int j = 0; j < base_count; j++)
+        {
+            if (strcmp(current[i].name, base[j].name) != 0 || base[j].ns_per_op <= 0)
+            {
+                continue;
+            }
+
+            double delta = current[i].ns_per_op - base[j].ns_per_op;
+            double change = delta * 100.0 / base[j].ns_per_op;
+            bool regression = change > threshold_pct && delta >= min_delta_ns;
+            regressions += regression;
+
+            printf("%s    {\"name\": \"%s\", \"base_ns\": %.2f, \"new_ns\": %.2f, \"change_pct\": %.1f, "
+                   "\"regression\": %s}",
+                   first ? "" : ",\n", current[i].name, base[j].ns_per_op, current[i].ns_per_op, change,
+                   regression ? "true" : "false");
+            first = false;
+
+            if (regression)
+            {
+                fprintf(stderr, "REGRESSION %s: %.1f -> %.1f ns/op (%+.1f%%)\n", current[i].name,
+                        base[j].ns_per_op, current[i].ns_per_op, change);
+            }
+            break;
+        }
+    }
+    printf("\n  ],\n  \"regressions\": %d\n}\n", regressions);
+
+    return regressions ? 1 : 0;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--iterations N] [--output FILE]\n"
+            "       %s --compare BASE.json NEW.json [--threshold PERCENT] [--min-delta NS]\n",
+            argv0, argv0);
+}
+
+int main(int argc, char **argv)
+{
+    const char *output = NULL;
+    const char *compare_paths[2] = {NULL, NULL};
+    double threshold_pct = DEFAULT_THRESHOLD_PCT;
+    double min_delta_ns = DEFAULT_MIN_DELTA_NS;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+        {
+            iterations = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "--compare") == 0 && i + 2 < argc)
+        {
+            compare_paths[0] = argv[++i];
+            compare_paths[1] = argv[++i];
+        }
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+        {
+            threshold_pct = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--min-delta") == 0 && i + 1 < argc)
+        {
+            min_delta_ns = atof(argv[++i]);
+        }
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (compare_paths[0])
+    {
+        return compare(compare_paths[0], compare_paths[1], threshold_pct, min_delta_ns);
+    }
+
+    if (iterations <= 0)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    bench_process_events();
+    bench_timer_dispatch();
+    bench_gpio_dispatch();
+    bench_publish();
+    bench_channel();
+    bench_gpio_edges();
+    bench_register();
+
+    FILE *out = output ? fopen(output, "w") : stdout;
+    if (out == NULL)
+    {
+        fprintf(stderr, "Cannot open %s\n", output);
+        return 2;
+    }
+    write_results(out);
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+
+    return callback_hits == 0;
+}
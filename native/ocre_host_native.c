@@ -0,0 +1,1752 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#define _GNU_SOURCE
+#include "ocre_native.h"
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define EVENT_QUEUE_SIZE 1024
+#define MAX_SUBSCRIPTIONS 64
+#define MAX_EXPORTS 32
+#define MAX_SENSOR_CHANNELS CONFIG_OCRE_SENSOR_STREAM_MAX_CHANNELS
+#define TIME_PAGE_PERIOD_NS 1000000 // Refresh interval of the guest time page
+
+// SDK-side names of runtime functions that the SDK wraps (see OCRE_IMPORT)
+int ocre_host_sensors_discover(void);
+int ocre_host_sensors_get_handle_by_name(const char *sensor_name);
+
+static pthread_mutex_t host_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t event_cond = PTHREAD_COND_INITIALIZER;
+
+// =============================================================================
+// TIME
+// =============================================================================
+
+uint64_t ocre_native_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static ocre_time_page_t *time_page = NULL;
+static pthread_t time_page_thread;
+
+// Caller holds host_lock, so there is a single writer; returns the time written
+static uint64_t time_page_update_locked(void)
+{
+    uint64_t now = ocre_native_time_ns();
+    if (time_page == NULL)
+    {
+        return now;
+    }
+
+    uint32_t seq = time_page->seq;
+    __atomic_store_n(&time_page->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&time_page->monotonic_ns, now, __ATOMIC_RELAXED);
+    __atomic_store_n(&time_page->seq, seq + 2, __ATOMIC_RELEASE);
+    return now;
+}
+
+static void *time_page_refresh(void *arg)
+{
+    struct timespec period = {.tv_sec = 0, .tv_nsec = TIME_PAGE_PERIOD_NS};
+
+    for (;;)
+    {
+        nanosleep(&period, NULL);
+        pthread_mutex_lock(&host_lock);
+        time_page_update_locked();
+        pthread_mutex_unlock(&host_lock);
+    }
+    return NULL;
+}
+
+int ocre_time_page_register(ocre_time_page_t *page)
+{
+    if (page == NULL || page->version != OCRE_TIME_PAGE_VERSION)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    bool first = time_page == NULL;
+    page->resolution_ns = TIME_PAGE_PERIOD_NS;
+    time_page = page;
+    time_page_update_locked();
+    pthread_mutex_unlock(&host_lock);
+
+    if (first)
+    {
+        if (pthread_create(&time_page_thread, NULL, time_page_refresh, NULL) != 0)
+        {
+            return OCRE_ERROR_NO_MEMORY;
+        }
+        pthread_detach(time_page_thread);
+    }
+    return OCRE_SUCCESS;
+}
+
+static struct timespec deadline_after_ms(int milliseconds)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += milliseconds / 1000;
+    ts.tv_nsec += (long)(milliseconds % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L)
+    {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+// =============================================================================
+// EVENTS
+// =============================================================================
+
+static event_data_t event_queue[EVENT_QUEUE_SIZE];
+static uint32_t event_queue_head = 0;
+static uint32_t event_queue_tail = 0;
+static ocre_event_ring_t *event_ring = NULL;
+static int held_ready = 0; // Rate-limited messages waiting to be delivered on the guest's thread
+
+static int ring_pending(void)
+{
+    if (event_ring == NULL)
+    {
+        return 0;
+    }
+    return (int)(__atomic_load_n(&event_ring->head, __ATOMIC_RELAXED) -
+                 __atomic_load_n(&event_ring->tail, __ATOMIC_ACQUIRE));
+}
+
+// Caller holds host_lock
+static int post_event_locked(int32_t type, int32_t id, int32_t port, int32_t state)
+{
+    event_data_t event = {
+        .type = type, .id = id, .port = port, .state = state, .timestamp_ns = time_page_update_locked()};
+
+    // Write straight into the guest ring unless events are already spilling into the queue
+    if (event_ring && event_ring->overflow == 0 && (uint32_t)ring_pending() < event_ring->capacity)
+    {
+        uint32_t head = event_ring->head;
+        event_ring->events[head & (event_ring->capacity - 1)] = event;
+        __atomic_store_n(&event_ring->head, head + 1, __ATOMIC_RELEASE);
+        pthread_cond_broadcast(&event_cond);
+        return OCRE_SUCCESS;
+    }
+
+    if (event_queue_head - event_queue_tail >= EVENT_QUEUE_SIZE)
+    {
+        return OCRE_ERROR_BUSY;
+    }
+
+    event_queue[event_queue_head++ % EVENT_QUEUE_SIZE] = event;
+    if (event_ring)
+    {
+        __atomic_store_n(&event_ring->overflow, 1, __ATOMIC_RELEASE);
+    }
+    pthread_cond_broadcast(&event_cond);
+    return OCRE_SUCCESS;
+}
+
+int ocre_native_post_event(int32_t type, int32_t id, int32_t port, int32_t state)
+{
+    pthread_mutex_lock(&host_lock);
+    int ret = post_event_locked(type, id, port, state);
+    pthread_mutex_unlock(&host_lock);
+    return ret;
+}
+
+int ocre_native_pending_events(void)
+{
+    pthread_mutex_lock(&host_lock);
+    int pending = ring_pending() + (int)(event_queue_head - event_queue_tail);
+    pthread_mutex_unlock(&host_lock);
+    return pending;
+}
+
+static void deliver_held_messages(void);
+
+int ocre_get_event(uintptr_t type_offset, uintptr_t id_offset, uintptr_t port_offset, uintptr_t state_offset)
+{
+    deliver_held_messages();
+
+    pthread_mutex_lock(&host_lock);
+
+    if (event_queue_head == event_queue_tail)
+    {
+        pthread_mutex_unlock(&host_lock);
+        return OCRE_ERROR_NOT_FOUND;
+    }
+
+    event_data_t event = event_queue[event_queue_tail++ % EVENT_QUEUE_SIZE];
+    if (event_ring && event_queue_head == event_queue_tail)
+    {
+        __atomic_store_n(&event_ring->overflow, 0, __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_unlock(&host_lock);
+
+    *(int32_t *)type_offset = event.type;
+    *(int32_t *)id_offset = event.id;
+    *(int32_t *)port_offset = event.port;
+    *(int32_t *)state_offset = event.state;
+    return OCRE_SUCCESS;
+}
+
+int ocre_register_event_ring(ocre_event_ring_t *ring, uint32_t capacity)
+{
+    if (ring == NULL || ring->version != OCRE_EVENT_RING_VERSION || capacity == 0 ||
+        (capacity & (capacity - 1)) != 0 || capacity != ring->capacity)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    event_ring = ring;
+
+    // Events already queued stay ahead of anything written to the ring
+    if (event_queue_head != event_queue_tail)
+    {
+        ring->overflow = 1;
+    }
+    pthread_mutex_unlock(&host_lock);
+    return OCRE_SUCCESS;
+}
+
+int ocre_wait_events(int timeout_ms)
+{
+    struct timespec deadline = deadline_after_ms(timeout_ms < 0 ? 0 : timeout_ms);
+    int ret = OCRE_SUCCESS;
+
+    pthread_mutex_lock(&host_lock);
+    while (event_queue_head == event_queue_tail && ring_pending() == 0 && held_ready == 0)
+    {
+        if (pthread_cond_clockwait(&event_cond, &host_lock, CLOCK_MONOTONIC, &deadline) == ETIMEDOUT)
+        {
+            ret = (event_queue_head == event_queue_tail && ring_pending() == 0 && held_ready == 0)
+                      ? OCRE_ERROR_TIMEOUT
+                      : OCRE_SUCCESS;
+            break;
+        }
+    }
+    time_page_update_locked();
+    pthread_mutex_unlock(&host_lock);
+
+    deliver_held_messages();
+    return ret;
+}
+
+int ocre_register_dispatcher(ocre_resource_type_t type, const char *function_name)
+{
+    // Events are always retrieved through ocre_get_event or the event ring
+    return (type >= 0 && type < OCRE_RESOURCE_TYPE_COUNT && function_name) ? OCRE_SUCCESS : OCRE_ERROR_INVALID;
+}
+
+// =============================================================================
+// TIMERS
+// =============================================================================
+
+typedef struct
+{
+    bool created;
+    timer_t timer;
+} native_timer_t;
+
+static native_timer_t timers[OCRE_MAX_TIMERS + 1];
+
+static void timer_expired(union sigval value)
+{
+    ocre_native_post_event(OCRE_RESOURCE_TYPE_TIMER, value.sival_int, 0, 0);
+}
+
+static native_timer_t *timer_get(int id)
+{
+    if (id < 1 || id > OCRE_MAX_TIMERS || !timers[id].created)
+    {
+        return NULL;
+    }
+    return &timers[id];
+}
+
+int ocre_timer_create(int id)
+{
+    if (id < 1 || id > OCRE_MAX_TIMERS)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    if (timers[id].created)
+    {
+        return OCRE_SUCCESS;
+    }
+
+    struct sigevent sev = {0};
+    sev.sigev_notify = SIGEV_THREAD;
+    sev.sigev_notify_function = timer_expired;
+    sev.sigev_value.sival_int = id;
+
+    if (timer_create(CLOCK_MONOTONIC, &sev, &timers[id].timer) != 0)
+    {
+        return OCRE_ERROR_NO_MEMORY;
+    }
+    timers[id].created = true;
+    return OCRE_SUCCESS;
+}
+
+int ocre_timer_delete(int id)
+{
+    native_timer_t *timer = timer_get(id);
+    if (timer == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    timer_delete(timer->timer);
+    timer->created = false;
+    return OCRE_SUCCESS;
+}
+
+int ocre_timer_start(int id, int interval, int is_periodic)
+{
+    native_timer_t *timer = timer_get(id);
+    if (timer == NULL || interval <= 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    struct itimerspec spec = {0};
+    spec.it_value.tv_sec = interval / 1000;
+    spec.it_value.tv_nsec = (long)(interval % 1000) * 1000000L;
+    if (is_periodic)
+    {
+        spec.it_interval = spec.it_value;
+    }
+    return timer_settime(timer->timer, 0, &spec, NULL) == 0 ? OCRE_SUCCESS : OCRE_ERROR_INVALID;
+}
+
+int ocre_timer_stop(int id)
+{
+    native_timer_t *timer = timer_get(id);
+    if (timer == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    struct itimerspec spec = {0};
+    return timer_settime(timer->timer, 0, &spec, NULL) == 0 ? OCRE_SUCCESS : OCRE_ERROR_INVALID;
+}
+
+int ocre_timer_get_remaining(int id)
+{
+    native_timer_t *timer = timer_get(id);
+    struct itimerspec spec;
+    if (timer == NULL || timer_gettime(timer->timer, &spec) != 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    // Round up so a running timer never reports 0
+    return (int)(spec.it_value.tv_sec * 1000 + (spec.it_value.tv_nsec + 999999L) / 1000000L);
+}
+
+// =============================================================================
+// UTILITY
+// =============================================================================
+
+int ocre_sleep(int milliseconds)
+{
+    struct timespec ts = {.tv_sec = milliseconds / 1000, .tv_nsec = (long)(milliseconds % 1000) * 1000000L};
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+    {
+    }
+    return OCRE_SUCCESS;
+}
+
+int uname(struct _ocre_posix_utsname *name)
+{
+    if (name == NULL)
+    {
+        return -1;
+    }
+
+    memset(name, 0, sizeof(*name));
+    snprintf(name->sysname, sizeof(name->sysname), "Ocre");
+    gethostname(name->nodename, sizeof(name->nodename) - 1);
+    snprintf(name->release, sizeof(name->release), "%s", OCRE_SDK_VERSION);
+    snprintf(name->version, sizeof(name->version), "native host emulation");
+    snprintf(name->machine, sizeof(name->machine), "native");
+    return 0;
+}
+
+// =============================================================================
+// GPIO
+// =============================================================================
+
+typedef struct
+{
+    ocre_gpio_port_mask_t state;
+    ocre_gpio_port_mask_t output;    // Bit set for output pins
+    ocre_gpio_port_mask_t callbacks; // Bit set for pins raising events
+    ocre_gpio_port_mask_t captured;  // Bit set for pins recording edges instead
+} native_gpio_port_t;
+
+typedef struct
+{
+    bool active;
+    int port;
+    int pin;
+    int edges;
+    int notify_every;
+    int window_ms;
+    uint32_t since_notify; // Edges recorded since the last notification
+    bool window_armed;
+    timer_t window_timer;
+    ocre_gpio_capture_t *ring;
+} native_capture_t;
+
+static native_gpio_port_t gpio_ports[CONFIG_OCRE_GPIO_MAX_PORTS];
+static native_capture_t captures[CONFIG_OCRE_GPIO_CAPTURE_MAX];
+
+static bool gpio_valid(int port, int pin)
+{
+    return port >= 0 && port < CONFIG_OCRE_GPIO_MAX_PORTS && pin >= 0 && pin < CONFIG_OCRE_GPIO_PINS_PER_PORT;
+}
+
+// Tell the guest how many edges are waiting; caller holds host_lock
+static void capture_notify_locked(int capture_id)
+{
+    native_capture_t *capture = &captures[capture_id];
+
+    capture->since_notify = 0;
+    if (capture->window_armed)
+    {
+        struct itimerspec disarm = {0};
+        timer_settime(capture->window_timer, 0, &disarm, NULL);
+        capture->window_armed = false;
+    }
+    post_event_locked(OCRE_RESOURCE_TYPE_GPIO_CAPTURE, capture_id, 0,
+                      (int32_t)(capture->ring->head - __atomic_load_n(&capture->ring->tail, __ATOMIC_ACQUIRE)));
+}
+
+static void capture_window_expired(union sigval value)
+{
+    pthread_mutex_lock(&host_lock);
+    native_capture_t *capture = &captures[value.sival_int];
+    if (capture->active && capture->window_armed)
+    {
+        capture->window_armed = false;
+        capture_notify_locked(value.sival_int);
+    }
+    pthread_mutex_unlock(&host_lock);
+}
+
+// Caller holds host_lock
+static void capture_edge_locked(int port, int pin, int state, uint64_t timestamp_ns)
+{
+    for (int id = 0; id < CONFIG_OCRE_GPIO_CAPTURE_MAX; id++)
+    {
+        native_capture_t *capture = &captures[id];
+        if (!capture->active || capture->port != port || capture->pin != pin ||
+            !(capture->edges & (state ? OCRE_GPIO_EDGE_RISING : OCRE_GPIO_EDGE_FALLING)))
+        {
+            continue;
+        }
+
+        ocre_gpio_capture_t *ring = capture->ring;
+        uint32_t head = ring->head;
+        if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= ring->capacity)
+        {
+            ring->dropped++;
+        }
+        else
+        {
+            ring->edges[head & (ring->capacity - 1)] = (ocre_gpio_edge_t){.timestamp_ns = timestamp_ns,
+                                                                          .state = (uint32_t)state};
+            __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+        }
+
+        capture->since_notify++;
+        if (capture->notify_every > 0 && capture->since_notify >= (uint32_t)capture->notify_every)
+        {
+            capture_notify_locked(id);
+        }
+        else if (capture->window_ms > 0 && !capture->window_armed)
+        {
+            struct itimerspec spec = {0};
+            spec.it_value.tv_sec = capture->window_ms / 1000;
+            spec.it_value.tv_nsec = (long)(capture->window_ms % 1000) * 1000000L;
+            timer_settime(capture->window_timer, 0, &spec, NULL);
+            capture->window_armed = true;
+        }
+    }
+}
+
+// Apply new levels to a port, record edges of captured pins and raise events for other changed pins with
+// callbacks; caller holds host_lock
+static void gpio_update_locked(int port, ocre_gpio_port_mask_t mask, ocre_gpio_port_mask_t value)
+{
+    native_gpio_port_t *p = &gpio_ports[port];
+    ocre_gpio_port_mask_t old_state = p->state;
+
+    p->state = (p->state & ~mask) | (value & mask);
+
+    ocre_gpio_port_mask_t changed = old_state ^ p->state;
+    ocre_gpio_port_mask_t captured = changed & p->captured;
+    if (captured)
+    {
+        uint64_t now = ocre_native_time_ns();
+        while (captured)
+        {
+            int pin = __builtin_ctz(captured);
+            captured &= captured - 1;
+            capture_edge_locked(port, pin, (p->state >> pin) & 1, now);
+        }
+    }
+
+    changed &= p->callbacks & ~p->captured;
+    while (changed)
+    {
+        int pin = __builtin_ctz(changed);
+        changed &= changed - 1;
+        post_event_locked(OCRE_RESOURCE_TYPE_GPIO, pin, port, (p->state >> pin) & 1);
+    }
+}
+
+int ocre_gpio_init(void)
+{
+    pthread_mutex_lock(&host_lock);
+    memset(gpio_ports, 0, sizeof(gpio_ports));
+    pthread_mutex_unlock(&host_lock);
+    return OCRE_SUCCESS;
+}
+
+int ocre_gpio_configure(int port, int pin, int direction)
+{
+    return gpio_valid(port, pin) ? ocre_gpio_configure_mask(port, OCRE_GPIO_PIN_MASK(pin), direction)
+                                 : OCRE_ERROR_INVALID;
+}
+
+int ocre_gpio_configure_mask(int port, ocre_gpio_port_mask_t mask, int direction)
+{
+    if (port < 0 || port >= CONFIG_OCRE_GPIO_MAX_PORTS || (mask & ~OCRE_GPIO_PORT_ALL_PINS) ||
+        (direction != OCRE_GPIO_DIR_INPUT && direction != OCRE_GPIO_DIR_OUTPUT))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    if (direction == OCRE_GPIO_DIR_OUTPUT)
+    {
+        gpio_ports[port].output |= mask;
+    }
+    else
+    {
+        gpio_ports[port].output &= ~mask;
+    }
+    pthread_mutex_unlock(&host_lock);
+    return OCRE_SUCCESS;
+}
+
+ocre_gpio_pin_state_t ocre_gpio_pin_get(int port, int pin)
+{
+    if (!gpio_valid(port, pin))
+    {
+        return (ocre_gpio_pin_state_t)OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    ocre_gpio_pin_state_t state = (ocre_gpio_pin_state_t)((gpio_ports[port].state >> pin) & 1);
+    pthread_mutex_unlock(&host_lock);
+    return state;
+}
+
+int ocre_gpio_pin_set(int port, int pin, ocre_gpio_pin_state_t state)
+{
+    if (!gpio_valid(port, pin))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    return ocre_gpio_port_set_masked(port, OCRE_GPIO_PIN_MASK(pin), state ? OCRE_GPIO_PIN_MASK(pin) : 0);
+}
+
+int ocre_gpio_pin_toggle(int port, int pin)
+{
+    return gpio_valid(port, pin) ? ocre_gpio_port_toggle(port, OCRE_GPIO_PIN_MASK(pin)) : OCRE_ERROR_INVALID;
+}
+
+int ocre_gpio_port_get(int port, ocre_gpio_port_mask_t *mask)
+{
+    if (port < 0 || port >= CONFIG_OCRE_GPIO_MAX_PORTS || mask == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    *mask = gpio_ports[port].state;
+    pthread_mutex_unlock(&host_lock);
+    return OCRE_SUCCESS;
+}
+
+int ocre_gpio_port_set_masked(int port, ocre_gpio_port_mask_t mask, ocre_gpio_port_mask_t value)
+{
+    if (port < 0 || port >= CONFIG_OCRE_GPIO_MAX_PORTS)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    gpio_update_locked(port, mask & gpio_ports[port].output, value);
+    pthread_mutex_unlock(&host_lock);
+    return OCRE_SUCCESS;
+}
+
+int ocre_gpio_port_toggle(int port, ocre_gpio_port_mask_t mask)
+{
+    if (port < 0 || port >= CONFIG_OCRE_GPIO_MAX_PORTS)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    mask &= gpio_ports[port].output;
+    gpio_update_locked(port, mask, ~gpio_ports[port].state);
+    pthread_mutex_unlock(&host_lock);
+    return OCRE_SUCCESS;
+}
+
+int ocre_gpio_register_callback(int port, int pin)
+{
+    if (!gpio_valid(port, pin))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    gpio_ports[port].callbacks |= OCRE_GPIO_PIN_MASK(pin);
+    pthread_mutex_unlock(&host_lock);
+    return OCRE_SUCCESS;
+}
+
+int ocre_gpio_unregister_callback(int port, int pin)
+{
+    if (!gpio_valid(port, pin))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    gpio_ports[port].callbacks &= ~OCRE_GPIO_PIN_MASK(pin);
+    pthread_mutex_unlock(&host_lock);
+    return OCRE_SUCCESS;
+}
+
+int ocre_native_gpio_input(int port, int pin, int state)
+{
+    if (!gpio_valid(port, pin))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    gpio_update_locked(port, OCRE_GPIO_PIN_MASK(pin), state ? OCRE_GPIO_PIN_MASK(pin) : 0);
+    pthread_mutex_unlock(&host_lock);
+    return OCRE_SUCCESS;
+}
+
+int ocre_gpio_capture_start(int port, int pin, int edges, int notify_every, int window_ms,
+                            ocre_gpio_capture_t *capture)
+{
+    if (!gpio_valid(port, pin) || capture == NULL || capture->version != OCRE_GPIO_CAPTURE_VERSION ||
+        capture->capacity == 0 || (capture->capacity & (capture->capacity - 1)) != 0 ||
+        (edges & ~OCRE_GPIO_EDGE_BOTH) != 0 || edges == 0 || notify_every < 0 || window_ms < 0 ||
+        (notify_every == 0 && window_ms == 0))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    int id = -1;
+    for (int i = 0; i < CONFIG_OCRE_GPIO_CAPTURE_MAX; i++)
+    {
+        if (captures[i].active && captures[i].port == port && captures[i].pin == pin)
+        {
+            pthread_mutex_unlock(&host_lock);
+            return OCRE_ERROR_BUSY;
+        }
+        if (!captures[i].active && id < 0)
+        {
+            id = i;
+        }
+    }
+    if (id < 0)
+    {
+        pthread_mutex_unlock(&host_lock);
+        return OCRE_ERROR_NO_MEMORY;
+    }
+
+    native_capture_t *c = &captures[id];
+    struct sigevent sev = {0};
+    sev.sigev_notify = SIGEV_THREAD;
+    sev.sigev_notify_function = capture_window_expired;
+    sev.sigev_value.sival_int = id;
+    if (timer_create(CLOCK_MONOTONIC, &sev, &c->window_timer) != 0)
+    {
+        pthread_mutex_unlock(&host_lock);
+        return OCRE_ERROR_NO_MEMORY;
+    }
+
+    c->port = port;
+    c->pin = pin;
+    c->edges = edges;
+    c->notify_every = notify_every;
+    c->window_ms = window_ms;
+    c->since_notify = 0;
+    c->window_armed = false;
+    c->ring = capture;
+    c->active = true;
+    gpio_ports[port].captured |= OCRE_GPIO_PIN_MASK(pin);
+    pthread_mutex_unlock(&host_lock);
+    return id;
+}
+
+int ocre_gpio_capture_stop(int capture_id)
+{
+    if (capture_id < 0 || capture_id >= CONFIG_OCRE_GPIO_CAPTURE_MAX)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    native_capture_t *c = &captures[capture_id];
+    if (!c->active)
+    {
+        pthread_mutex_unlock(&host_lock);
+        return OCRE_ERROR_NOT_FOUND;
+    }
+
+    c->active = false;
+    c->ring = NULL;
+    gpio_ports[c->port].captured &= ~OCRE_GPIO_PIN_MASK(c->pin);
+    timer_t window_timer = c->window_timer;
+    pthread_mutex_unlock(&host_lock);
+
+    // An expiry already in flight finds the capture inactive
+    timer_delete(window_timer);
+    return OCRE_SUCCESS;
+}
+
+// =============================================================================
+// SENSORS
+// =============================================================================
+
+typedef struct
+{
+    bool used;
+    bool opened;
+    char name[CONFIG_MAX_SENSOR_NAME_LENGTH + 1];
+    int channel_count;
+    int channel_types[MAX_SENSOR_CHANNELS];
+    ocre_native_sensor_fn_t fn;
+    void *user_ctx;
+
+    // Streaming state
+    bool streaming;
+    timer_t stream_timer;
+    ocre_sensor_stream_t *stream;
+    int stream_channels[MAX_SENSOR_CHANNELS];
+    int stream_channel_count;
+    int notify_every;
+    uint32_t samples_since_notify;
+} native_sensor_t;
+
+static native_sensor_t sensors[OCRE_MAX_SENSORS];
+
+static native_sensor_t *sensor_get(int sensor_id)
+{
+    if (sensor_id < 0 || sensor_id >= OCRE_MAX_SENSORS || !sensors[sensor_id].used)
+    {
+        return NULL;
+    }
+    return &sensors[sensor_id];
+}
+
+static bool sensor_has_channel(const native_sensor_t *sensor, int channel_type)
+{
+    for (int i = 0; i < sensor->channel_count; i++)
+    {
+        if (sensor->channel_types[i] == channel_type)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int ocre_native_sensor_add(const char *name, const int *channel_types, int channel_count, ocre_native_sensor_fn_t fn,
+                           void *user_ctx)
+{
+    if (name == NULL || strlen(name) > CONFIG_MAX_SENSOR_NAME_LENGTH || channel_types == NULL || channel_count <= 0 ||
+        channel_count > MAX_SENSOR_CHANNELS || fn == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    int id = OCRE_ERROR_NO_MEMORY;
+    for (int i = 0; i < OCRE_MAX_SENSORS; i++)
+    {
+        if (!sensors[i].used)
+        {
+            native_sensor_t *sensor = &sensors[i];
+            memset(sensor, 0, sizeof(*sensor));
+            sensor->used = true;
+            snprintf(sensor->name, sizeof(sensor->name), "%s", name);
+            sensor->channel_count = channel_count;
+            memcpy(sensor->channel_types, channel_types, sizeof(int) * (size_t)channel_count);
+            sensor->fn = fn;
+            sensor->user_ctx = user_ctx;
+            id = i;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&host_lock);
+    return id;
+}
+
+int ocre_sensors_init(void)
+{
+    return OCRE_SUCCESS;
+}
+
+int ocre_host_sensors_discover(void)
+{
+    int count = 0;
+    for (int i = 0; i < OCRE_MAX_SENSORS; i++)
+    {
+        count += sensors[i].used;
+    }
+    return count;
+}
+
+int ocre_sensors_open(ocre_sensor_handle_t handle)
+{
+    native_sensor_t *sensor = sensor_get(handle);
+    if (sensor == NULL)
+    {
+        return OCRE_ERROR_NOT_FOUND;
+    }
+    sensor->opened = true;
+    return OCRE_SUCCESS;
+}
+
+int ocre_sensors_get_handle(int sensor_id)
+{
+    return sensor_get(sensor_id) ? sensor_id : OCRE_ERROR_NOT_FOUND;
+}
+
+int ocre_host_sensors_get_handle_by_name(const char *sensor_name)
+{
+    for (int i = 0; sensor_name && i < OCRE_MAX_SENSORS; i++)
+    {
+        if (sensors[i].used && strcmp(sensors[i].name, sensor_name) == 0)
+        {
+            return i;
+        }
+    }
+    return OCRE_ERROR_NOT_FOUND;
+}
+
+int ocre_sensors_get_channel_count(int sensor_id)
+{
+    native_sensor_t *sensor = sensor_get(sensor_id);
+    return sensor ? sensor->channel_count : OCRE_ERROR_NOT_FOUND;
+}
+
+int ocre_sensors_get_channel_type(int sensor_id, int channel_index)
+{
+    native_sensor_t *sensor = sensor_get(sensor_id);
+    if (sensor == NULL)
+    {
+        return OCRE_ERROR_NOT_FOUND;
+    }
+    if (channel_index < 0 || channel_index >= sensor->channel_count)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    return sensor->channel_types[channel_index];
+}
+
+int ocre_sensors_read(int sensor_id, int channel_type)
+{
+    native_sensor_t *sensor = sensor_get(sensor_id);
+    if (sensor == NULL)
+    {
+        return OCRE_ERROR_NOT_FOUND;
+    }
+    if (!sensor_has_channel(sensor, channel_type))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    return (int)(sensor->fn(channel_type, ocre_native_time_ns(), sensor->user_ctx) / OCRE_SENSOR_VALUE_SCALE);
+}
+
+int ocre_sensors_read_multi(int sensor_id, const int *channel_types, ocre_sensor_value_t *values, int count,
+                            uint64_t *timestamp_ns)
+{
+    native_sensor_t *sensor = sensor_get(sensor_id);
+    if (sensor == NULL)
+    {
+        return OCRE_ERROR_NOT_FOUND;
+    }
+    if (channel_types == NULL || values == NULL || count < 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    uint64_t now = ocre_native_time_ns();
+    for (int i = 0; i < count; i++)
+    {
+        if (!sensor_has_channel(sensor, channel_types[i]))
+        {
+            return OCRE_ERROR_INVALID;
+        }
+        values[i] = sensor->fn(channel_types[i], now, sensor->user_ctx);
+    }
+
+    if (timestamp_ns)
+    {
+        *timestamp_ns = now;
+    }
+    return count;
+}
+
+static void stream_sample(union sigval value)
+{
+    native_sensor_t *sensor = &sensors[value.sival_int];
+
+    pthread_mutex_lock(&host_lock);
+    ocre_sensor_stream_t *stream = sensor->stream;
+    if (!sensor->streaming || stream == NULL)
+    {
+        pthread_mutex_unlock(&host_lock);
+        return;
+    }
+
+    uint32_t head = stream->head;
+    if (head - __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE) >= stream->capacity)
+    {
+        stream->dropped++;
+    }
+    else
+    {
+        ocre_sensor_sample_t *sample = &stream->samples[head & (stream->capacity - 1)];
+        sample->timestamp_ns = ocre_native_time_ns();
+        for (int i = 0; i < sensor->stream_channel_count; i++)
+        {
+            sample->values[i] = sensor->fn(sensor->stream_channels[i], sample->timestamp_ns, sensor->user_ctx);
+        }
+        __atomic_store_n(&stream->head, head + 1, __ATOMIC_RELEASE);
+    }
+
+    if (++sensor->samples_since_notify >= (uint32_t)sensor->notify_every)
+    {
+        sensor->samples_since_notify = 0;
+        post_event_locked(OCRE_RESOURCE_TYPE_SENSOR, value.sival_int, 0,
+                          (int32_t)(stream->head - __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE)));
+    }
+    pthread_mutex_unlock(&host_lock);
+}
+
+int ocre_sensors_stream_start(int sensor_id, const int *channel_types, int channel_count, int rate_hz,
+                              int notify_every, ocre_sensor_stream_t *stream)
+{
+    native_sensor_t *sensor = sensor_get(sensor_id);
+    if (sensor == NULL)
+    {
+        return OCRE_ERROR_NOT_FOUND;
+    }
+    if (stream == NULL || stream->version != OCRE_SENSOR_STREAM_VERSION || channel_types == NULL ||
+        channel_count <= 0 || channel_count > MAX_SENSOR_CHANNELS || rate_hz <= 0 || notify_every <= 0 ||
+        sensor->streaming)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    for (int i = 0; i < channel_count; i++)
+    {
+        if (!sensor_has_channel(sensor, channel_types[i]))
+        {
+            return OCRE_ERROR_INVALID;
+        }
+    }
+
+    struct sigevent sev = {0};
+    sev.sigev_notify = SIGEV_THREAD;
+    sev.sigev_notify_function = stream_sample;
+    sev.sigev_value.sival_int = sensor_id;
+    if (timer_create(CLOCK_MONOTONIC, &sev, &sensor->stream_timer) != 0)
+    {
+        return OCRE_ERROR_NO_MEMORY;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    sensor->stream = stream;
+    memcpy(sensor->stream_channels, channel_types, sizeof(int) * (size_t)channel_count);
+    sensor->stream_channel_count = channel_count;
+    sensor->notify_every = notify_every;
+    sensor->samples_since_notify = 0;
+    sensor->streaming = true;
+    pthread_mutex_unlock(&host_lock);
+
+    long period_ns = 1000000000L / rate_hz;
+    struct itimerspec spec = {0};
+    spec.it_value.tv_sec = period_ns / 1000000000L;
+    spec.it_value.tv_nsec = period_ns % 1000000000L;
+    spec.it_interval = spec.it_value;
+    timer_settime(sensor->stream_timer, 0, &spec, NULL);
+    return OCRE_SUCCESS;
+}
+
+int ocre_sensors_stream_stop(int sensor_id)
+{
+    native_sensor_t *sensor = sensor_get(sensor_id);
+    if (sensor == NULL || !sensor->streaming)
+    {
+        return OCRE_ERROR_NOT_FOUND;
+    }
+
+    timer_delete(sensor->stream_timer);
+
+    pthread_mutex_lock(&host_lock);
+    sensor->streaming = false;
+    sensor->stream = NULL;
+    pthread_mutex_unlock(&host_lock);
+    return OCRE_SUCCESS;
+}
+
+// =============================================================================
+// CHANNELS
+// =============================================================================
+
+// A native process hosts a single container, so both ends of a channel live here
+typedef struct
+{
+    char name[OCRE_MAX_CHANNEL_NAME_LEN];
+    ocre_channel_ring_t *ring;
+    int ends[2]; // Channel ID per ocre_channel_role_t, -1 if detached
+} native_channel_t;
+
+typedef struct
+{
+    native_channel_t *channel;
+    int role;
+} native_channel_end_t;
+
+static native_channel_t channels[CONFIG_OCRE_CHANNEL_MAX];
+static native_channel_end_t channel_ends[CONFIG_OCRE_CHANNEL_MAX];
+
+static native_channel_t *channel_find_locked(const char *name)
+{
+    for (int i = 0; i < CONFIG_OCRE_CHANNEL_MAX; i++)
+    {
+        if (channels[i].ring && strcmp(channels[i].name, name) == 0)
+        {
+            return &channels[i];
+        }
+    }
+    return NULL;
+}
+
+static native_channel_t *channel_create_locked(const char *name, uint32_t capacity, uint32_t msg_size)
+{
+    for (int i = 0; i < CONFIG_OCRE_CHANNEL_MAX; i++)
+    {
+        native_channel_t *channel = &channels[i];
+        if (channel->ring)
+        {
+            continue;
+        }
+
+        size_t size = (OCRE_CHANNEL_RING_SIZE(capacity, msg_size) + 63) & ~(size_t)63;
+        channel->ring = aligned_alloc(64, size);
+        if (channel->ring == NULL)
+        {
+            return NULL;
+        }
+
+        memset(channel->ring, 0, size);
+        channel->ring->version = OCRE_CHANNEL_VERSION;
+        channel->ring->capacity = capacity;
+        channel->ring->msg_size = msg_size;
+        channel->ring->slot_size = OCRE_CHANNEL_SLOT_SIZE(msg_size);
+        channel->ring->consumer_waiting = 1; // The first message wakes the consumer
+        snprintf(channel->name, sizeof(channel->name), "%s", name);
+        channel->ends[0] = channel->ends[1] = -1;
+        return channel;
+    }
+    return NULL;
+}
+
+static int channel_end_alloc_locked(native_channel_t *channel, int role)
+{
+    for (int id = 0; id < CONFIG_OCRE_CHANNEL_MAX; id++)
+    {
+        if (channel_ends[id].channel == NULL)
+        {
+            channel_ends[id].channel = channel;
+            channel_ends[id].role = role;
+            channel->ends[role] = id;
+            __atomic_or_fetch(&channel->ring->attached, 1u << role, __ATOMIC_RELEASE);
+            return id;
+        }
+    }
+    return OCRE_ERROR_NO_MEMORY;
+}
+
+// Wake the other end of channel_id, if attached
+static void channel_signal_peer_locked(int channel_id)
+{
+    native_channel_end_t *end = &channel_ends[channel_id];
+    int peer = end->channel->ends[!end->role];
+    if (peer >= 0)
+    {
+        post_event_locked(OCRE_RESOURCE_TYPE_CHANNEL, peer, 0, 0);
+    }
+}
+
+static void channel_detach_locked(int channel_id)
+{
+    native_channel_end_t *end = &channel_ends[channel_id];
+    native_channel_t *channel = end->channel;
+
+    channel->ends[end->role] = -1;
+    __atomic_and_fetch(&channel->ring->attached, ~(1u << end->role), __ATOMIC_RELEASE);
+    end->channel = NULL;
+
+    if (channel->ends[0] < 0 && channel->ends[1] < 0)
+    {
+        free(channel->ring);
+        memset(channel, 0, sizeof(*channel));
+    }
+    else
+    {
+        // Let the remaining end notice through ring->attached
+        post_event_locked(OCRE_RESOURCE_TYPE_CHANNEL, channel->ends[!end->role], 0, 0);
+    }
+}
+
+int ocre_channel_attach(const char *name, int role, uint32_t capacity, uint32_t msg_size,
+                        ocre_channel_ring_t **ring)
+{
+    if (name == NULL || strlen(name) >= OCRE_MAX_CHANNEL_NAME_LEN || ring == NULL ||
+        (role != OCRE_CHANNEL_PRODUCER && role != OCRE_CHANNEL_CONSUMER) || capacity == 0 ||
+        (capacity & (capacity - 1)) != 0 || msg_size == 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+
+    int ret;
+    native_channel_t *channel = channel_find_locked(name);
+    if (channel && (channel->ring->capacity != capacity || channel->ring->msg_size != msg_size))
+    {
+        ret = OCRE_ERROR_INVALID;
+    }
+    else if (channel && channel->ends[role] >= 0)
+    {
+        ret = OCRE_ERROR_BUSY;
+    }
+    else
+    {
+        bool created = channel == NULL;
+        if (created)
+        {
+            channel = channel_create_locked(name, capacity, msg_size);
+        }
+
+        ret = channel ? channel_end_alloc_locked(channel, role) : OCRE_ERROR_NO_MEMORY;
+        if (ret >= 0)
+        {
+            *ring = channel->ring;
+
+            // Messages written before the consumer attached still need a wakeup
+            if (role == OCRE_CHANNEL_CONSUMER && channel->ring->head != channel->ring->tail)
+            {
+                post_event_locked(OCRE_RESOURCE_TYPE_CHANNEL, ret, 0, 0);
+            }
+        }
+        else if (created && channel)
+        {
+            free(channel->ring);
+            memset(channel, 0, sizeof(*channel));
+        }
+    }
+
+    pthread_mutex_unlock(&host_lock);
+    return ret;
+}
+
+int ocre_channel_detach(int channel_id)
+{
+    int ret = OCRE_ERROR_NOT_FOUND;
+
+    pthread_mutex_lock(&host_lock);
+    if (channel_id >= 0 && channel_id < CONFIG_OCRE_CHANNEL_MAX && channel_ends[channel_id].channel)
+    {
+        channel_detach_locked(channel_id);
+        ret = OCRE_SUCCESS;
+    }
+    pthread_mutex_unlock(&host_lock);
+    return ret;
+}
+
+int ocre_channel_signal(int channel_id)
+{
+    int ret = OCRE_ERROR_NOT_FOUND;
+
+    pthread_mutex_lock(&host_lock);
+    if (channel_id >= 0 && channel_id < CONFIG_OCRE_CHANNEL_MAX && channel_ends[channel_id].channel)
+    {
+        channel_signal_peer_locked(channel_id);
+        ret = OCRE_SUCCESS;
+    }
+    pthread_mutex_unlock(&host_lock);
+    return ret;
+}
+
+// =============================================================================
+// MESSAGING
+// =============================================================================
+
+// Loaned publishes go through the same filters, so a held payload can be as large as a loan buffer
+#define HELD_PAYLOAD_MAX \
+    (OCRE_MAX_PAYLOAD_LEN > CONFIG_OCRE_MSG_LOAN_BUFFER_SIZE ? OCRE_MAX_PAYLOAD_LEN : CONFIG_OCRE_MSG_LOAN_BUFFER_SIZE)
+
+// Latest message held back by a conflating rate limit
+typedef struct
+{
+    bool pending;
+    bool ready; // Interval has passed; delivered on the guest's thread
+    char topic[OCRE_MAX_TOPIC_LEN];
+    char content_type[OCRE_MAX_CONTENT_TYPE_LEN];
+    uint8_t payload[HELD_PAYLOAD_MAX];
+    uint32_t payload_len;
+} native_held_msg_t;
+
+typedef struct
+{
+    bool used;
+    char topic[OCRE_MAX_TOPIC_LEN];
+    ocre_native_msg_handler_t handler;
+    bool filtered;
+    ocre_msg_filter_t filter;
+    uint64_t next_delivery_ns; // Rate limit: earliest time of the next delivery
+    native_held_msg_t *held;   // Allocated for OCRE_MSG_FILTER_LATEST_ONLY with a rate limit
+    timer_t held_timer;
+    uint32_t generation; // Matches the held timer's expiries to this use of the slot
+} native_subscription_t;
+
+typedef struct
+{
+    const char *name;
+    ocre_native_msg_handler_t handler;
+} native_export_t;
+
+static native_subscription_t subscriptions[MAX_SUBSCRIPTIONS];
+static uint32_t subscription_generations[MAX_SUBSCRIPTIONS]; // Survives cleanup, so a reused slot gets a new one
+static native_export_t exports[MAX_EXPORTS];
+static ocre_msg_pool_t *msg_pool = NULL;
+
+// Reference held by a loaned delivery until the subscriber releases it
+typedef struct
+{
+    bool used;
+    uint32_t mid;
+    ocre_msg_pool_t *pool;
+    uint32_t index;
+} native_loan_ref_t;
+
+// Outstanding loaned deliveries; a publish that cannot record all of its references fails before delivering
+static native_loan_ref_t loan_refs[MAX_SUBSCRIPTIONS * CONFIG_OCRE_MSG_LOAN_BUFFERS];
+static uint32_t next_mid = 0;
+
+int ocre_native_register_export(const char *name, ocre_native_msg_handler_t handler)
+{
+    if (name == NULL || handler == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    for (int i = 0; i < MAX_EXPORTS; i++)
+    {
+        if (exports[i].name == NULL || strcmp(exports[i].name, name) == 0)
+        {
+            exports[i].name = name;
+            exports[i].handler = handler;
+            return OCRE_SUCCESS;
+        }
+    }
+    return OCRE_ERROR_NO_MEMORY;
+}
+
+static ocre_native_msg_handler_t resolve_export(const char *name)
+{
+    for (int i = 0; i < MAX_EXPORTS && exports[i].name; i++)
+    {
+        if (strcmp(exports[i].name, name) == 0)
+        {
+            return exports[i].handler;
+        }
+    }
+
+    // Fall back to the dynamic symbol table (ocre_host_native links executables with -rdynamic)
+    return (ocre_native_msg_handler_t)dlsym(RTLD_DEFAULT, name);
+}
+
+// Bounds of the names recorded by OCRE_EXPORT; weak so a program without exports still links
+extern const char *const __start_ocre_exports[] __attribute__((weak));
+extern const char *const __stop_ocre_exports[] __attribute__((weak));
+
+// A WebAssembly export takes the name given to OCRE_EXPORT, but natively only the C identifier is visible. Report any
+// name that does not match its function before a subscription or dispatch silently fails to find it.
+__attribute__((constructor)) static void check_exports(void)
+{
+    for (const char *const *name = __start_ocre_exports; name && name < __stop_ocre_exports; name++)
+    {
+        if (resolve_export(*name) == NULL)
+        {
+            OCRE_LOG_ERR("OCRE_EXPORT(\"%s\") does not name a function; use the function's own name\n", *name);
+        }
+    }
+}
+
+void ocre_msg_system_init(void)
+{
+}
+
+void ocre_messaging_register_module(wasm_module_inst_t module_inst)
+{
+}
+
+// Free a subscription slot. Caller holds host_lock
+static void subscription_clear_locked(native_subscription_t *sub)
+{
+    if (sub->held)
+    {
+        // An expiry in flight no longer matches the slot's generation, even once the slot is reused
+        timer_delete(sub->held_timer);
+        if (sub->held->ready)
+        {
+            held_ready--;
+        }
+        free(sub->held);
+    }
+    memset(sub, 0, sizeof(*sub));
+}
+
+void ocre_messaging_cleanup_container(wasm_module_inst_t module_inst)
+{
+    // A native process hosts a single container
+    pthread_mutex_lock(&host_lock);
+    for (int i = 0; i < MAX_SUBSCRIPTIONS; i++)
+    {
+        subscription_clear_locked(&subscriptions[i]);
+    }
+    msg_pool = NULL;
+    memset(loan_refs, 0, sizeof(loan_refs));
+    for (int id = 0; id < CONFIG_OCRE_CHANNEL_MAX; id++)
+    {
+        if (channel_ends[id].channel)
+        {
+            channel_detach_locked(id);
+        }
+    }
+    pthread_mutex_unlock(&host_lock);
+}
+
+static void held_expired(union sigval value);
+
+// The timer's value carries the slot in the low bits and the slot's generation above them
+#define HELD_SLOT_BITS 8
+#define HELD_GENERATION_MASK (UINT32_MAX >> (HELD_SLOT_BITS + 1))
+_Static_assert(MAX_SUBSCRIPTIONS <= (1 << HELD_SLOT_BITS), "MAX_SUBSCRIPTIONS does not fit the held timer value");
+
+static int subscribe(char *topic, char *handler_name, const ocre_msg_filter_t *filter)
+{
+    if (topic == NULL || handler_name == NULL || strlen(topic) >= OCRE_MAX_TOPIC_LEN)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    ocre_native_msg_handler_t handler = resolve_export(handler_name);
+    if (handler == NULL)
+    {
+        return OCRE_ERROR_NOT_FOUND;
+    }
+
+    int ret = OCRE_ERROR_NO_MEMORY;
+    pthread_mutex_lock(&host_lock);
+    for (int i = 0; i < MAX_SUBSCRIPTIONS; i++)
+    {
+        native_subscription_t *sub = &subscriptions[i];
+        if (sub->used)
+        {
+            continue;
+        }
+
+        uint32_t generation = ++subscription_generations[i] & HELD_GENERATION_MASK;
+        if (filter && (filter->flags & OCRE_MSG_FILTER_LATEST_ONLY) && filter->max_rate_hz > 0)
+        {
+            struct sigevent sev = {0};
+            sev.sigev_notify = SIGEV_THREAD;
+            sev.sigev_notify_function = held_expired;
+            sev.sigev_value.sival_int = (int)(generation << HELD_SLOT_BITS | (uint32_t)i);
+            sub->held = calloc(1, sizeof(*sub->held));
+            if (sub->held == NULL || timer_create(CLOCK_MONOTONIC, &sev, &sub->held_timer) != 0)
+            {
+                free(sub->held);
+                sub->held = NULL;
+                break;
+            }
+        }
+
+        sub->used = true;
+        sub->generation = generation;
+        snprintf(sub->topic, sizeof(sub->topic), "%s", topic);
+        sub->handler = handler;
+        sub->filtered = filter != NULL;
+        if (filter)
+        {
+            sub->filter = *filter;
+        }
+        sub->next_delivery_ns = 0;
+        ret = OCRE_SUCCESS;
+        break;
+    }
+    pthread_mutex_unlock(&host_lock);
+    return ret;
+}
+
+int ocre_subscribe_message(char *topic, char *handler_name)
+{
+    return subscribe(topic, handler_name, NULL);
+}
+
+int ocre_subscribe_message_filtered(char *topic, char *handler_name, const ocre_msg_filter_t *filter)
+{
+    if (filter == NULL || filter->version != OCRE_MSG_FILTER_VERSION ||
+        filter->predicate_count > CONFIG_OCRE_MSG_FILTER_MAX_PREDICATES ||
+        memchr(filter->content_type, '\0', sizeof(filter->content_type)) == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    return subscribe(topic, handler_name, filter);
+}
+
+int ocre_unsubscribe_message(char *topic, char *handler_name)
+{
+    if (topic == NULL || handler_name == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    ocre_native_msg_handler_t handler = resolve_export(handler_name);
+    int ret = OCRE_ERROR_NOT_FOUND;
+
+    pthread_mutex_lock(&host_lock);
+    for (int i = 0; i < MAX_SUBSCRIPTIONS; i++)
+    {
+        native_subscription_t *sub = &subscriptions[i];
+        if (sub->used && sub->handler == handler && strncmp(sub->topic, topic, sizeof(sub->topic)) == 0)
+        {
+            subscription_clear_locked(sub);
+            ret = OCRE_SUCCESS;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&host_lock);
+    return ret;
+}
+
+// The interval of a held message has passed. Runs on a timer thread, so only marks the message ready and wakes the
+// guest; deliver_held_messages() calls the handler on the guest's thread
+static void held_expired(union sigval value)
+{
+    uint32_t slot = (uint32_t)value.sival_int & ((1u << HELD_SLOT_BITS) - 1);
+    uint32_t generation = (uint32_t)value.sival_int >> HELD_SLOT_BITS;
+
+    pthread_mutex_lock(&host_lock);
+    native_subscription_t *sub = &subscriptions[slot];
+    if (sub->used && sub->generation == generation && sub->held && sub->held->pending && !sub->held->ready)
+    {
+        sub->held->ready = true;
+        held_ready++;
+        pthread_cond_broadcast(&event_cond);
+    }
+    pthread_mutex_unlock(&host_lock);
+}
+
+// Deliver the messages a conflating rate limit held back once their interval has passed. Called on the guest's
+// thread from the event and publish entry points, as the runtime would
+static void deliver_held_messages(void)
+{
+    native_held_msg_t held;
+
+    for (int i = 0; i < MAX_SUBSCRIPTIONS; i++)
+    {
+        pthread_mutex_lock(&host_lock);
+        native_subscription_t *sub = &subscriptions[i];
+        if (held_ready == 0)
+        {
+            pthread_mutex_unlock(&host_lock);
+            return;
+        }
+        if (!sub->used || sub->held == NULL || !sub->held->ready)
+        {
+            pthread_mutex_unlock(&host_lock);
+            continue;
+        }
+        held = *sub->held;
+        sub->held->pending = false;
+        sub->held->ready = false;
+        held_ready--;
+        sub->next_delivery_ns = ocre_native_time_ns() + 1000000000u / sub->filter.max_rate_hz;
+        ocre_native_msg_handler_t handler = sub->handler;
+        pthread_mutex_unlock(&host_lock);
+
+        ocre_msg_t msg = {
+            .mid = __atomic_fetch_add(&next_mid, 1, __ATOMIC_RELAXED),
+            .topic = held.topic,
+            .content_type = held.content_type,
+            .payload = held.payload,
+            .payload_len = held.payload_len,
+        };
+        handler(&msg);
+    }
+}
+
+// Apply a subscription's filter; returns true if the message is to be delivered now. Caller holds host_lock
+static bool filter_admit_locked(native_subscription_t *sub, const ocre_msg_t *msg)
+{
+    if (!sub->filtered)
+    {
+        return true;
+    }
+    if (!ocre_msg_filter_match(&sub->filter, msg))
+    {
+        return false;
+    }
+    if (sub->filter.max_rate_hz == 0)
+    {
+        return true;
+    }
+
+    uint64_t now = ocre_native_time_ns();
+    if (now >= sub->next_delivery_ns && (sub->held == NULL || !sub->held->pending))
+    {
+        sub->next_delivery_ns = now + 1000000000u / sub->filter.max_rate_hz;
+        return true;
+    }
+
+    if (sub->held && msg->payload_len > sizeof(sub->held->payload))
+    {
+        // Only a pool registered with larger buffers than this build's gets here; drop as without LATEST_ONLY
+        OCRE_LOG_WRN("Payload of %u bytes on %s too large to hold back\n", (unsigned)msg->payload_len, msg->topic);
+        return false;
+    }
+
+    if (sub->held)
+    {
+        // Replace any older held message; whichever is newest is delivered when the interval ends
+        native_held_msg_t *held = sub->held;
+        if (!held->pending)
+        {
+            uint64_t delay_ns = sub->next_delivery_ns > now ? sub->next_delivery_ns - now : 1;
+            struct itimerspec spec = {0};
+            spec.it_value.tv_sec = (time_t)(delay_ns / 1000000000u);
+            spec.it_value.tv_nsec = (long)(delay_ns % 1000000000u);
+            timer_settime(sub->held_timer, 0, &spec, NULL);
+        }
+        held->pending = true;
+        snprintf(held->topic, sizeof(held->topic), "%s", msg->topic);
+        snprintf(held->content_type, sizeof(held->content_type), "%s", msg->content_type);
+        held->payload_len = msg->payload_len;
+        if (msg->payload_len > 0)
+        {
+            memcpy(held->payload, msg->payload, msg->payload_len);
+        }
+    }
+    return false;
+}
+
+// Collect handlers subscribed to a prefix of the topic whose filters admit the message; handlers run without
+// host_lock held
+static int match_subscribers(const ocre_msg_t *msg, ocre_native_msg_handler_t *handlers)
+{
+    int count = 0;
+
+    pthread_mutex_lock(&host_lock);
+    for (int i = 0; i < MAX_SUBSCRIPTIONS; i++)
+    {
+        native_subscription_t *sub = &subscriptions[i];
+        if (sub->used && strncmp(sub->topic, msg->topic, strlen(sub->topic)) == 0 && filter_admit_locked(sub, msg))
+        {
+            handlers[count++] = sub->handler;
+        }
+    }
+    pthread_mutex_unlock(&host_lock);
+    return count;
+}
+
+int ocre_publish_message(char *topic, char *content_type, void *payload, int payload_len)
+{
+    if (topic == NULL || content_type == NULL || payload_len < 0 || payload_len > OCRE_MAX_PAYLOAD_LEN ||
+        (payload == NULL && payload_len > 0))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    deliver_held_messages();
+
+    ocre_native_msg_handler_t handlers[MAX_SUBSCRIPTIONS];
+    ocre_msg_t published = {
+        .topic = topic, .content_type = content_type, .payload = payload, .payload_len = (uint32_t)payload_len};
+    int count = match_subscribers(&published, handlers);
+    if (count == 0)
+    {
+        return OCRE_SUCCESS;
+    }
+
+    // Each subscriber gets its own copy, as it would in another container's memory
+    char topic_copy[OCRE_MAX_TOPIC_LEN];
+    char content_type_copy[OCRE_MAX_CONTENT_TYPE_LEN];
+    uint8_t payload_copy[OCRE_MAX_PAYLOAD_LEN];
+
+    for (int i = 0; i < count; i++)
+    {
+        snprintf(topic_copy, sizeof(topic_copy), "%s", topic);
+        snprintf(content_type_copy, sizeof(content_type_copy), "%s", content_type);
+        if (payload_len > 0)
+        {
+            memcpy(payload_copy, payload, (size_t)payload_len);
+        }
+
+        ocre_msg_t msg = {
+            .mid = __atomic_fetch_add(&next_mid, 1, __ATOMIC_RELAXED),
+            .topic = topic_copy,
+            .content_type = content_type_copy,
+            .payload = payload_copy,
+            .payload_len = (uint32_t)payload_len,
+        };
+        handlers[i](&msg);
+    }
+    return OCRE_SUCCESS;
+}
+
+int ocre_msg_pool_register(ocre_msg_pool_t *pool)
+{
+    if (pool == NULL || pool->version != OCRE_MSG_POOL_VERSION)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    msg_pool = pool;
+    pthread_mutex_unlock(&host_lock);
+    return OCRE_SUCCESS;
+}
+
+int ocre_publish_message_loaned(char *topic, char *content_type, uint32_t buffer_index, uint32_t payload_len)
+{
+    ocre_msg_pool_t *pool = msg_pool;
+    if (pool == NULL || topic == NULL || content_type == NULL || buffer_index >= pool->buffer_count ||
+        payload_len > pool->buffer_size)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    deliver_held_messages();
+
+    ocre_native_msg_handler_t handlers[MAX_SUBSCRIPTIONS];
+    ocre_msg_t published = {
+        .topic = topic,
+        .content_type = content_type,
+        .payload = pool->buffers[buffer_index],
+        .payload_len = payload_len,
+    };
+    int count = match_subscribers(&published, handlers);
+    uint32_t mids[MAX_SUBSCRIPTIONS];
+    int free_refs = 0;
+
+    // Record every subscriber's reference before the first delivery, or deliver to none of them
+    pthread_mutex_lock(&host_lock);
+    for (size_t slot = 0; slot < sizeof(loan_refs) / sizeof(loan_refs[0]) && free_refs < count; slot++)
+    {
+        free_refs += !loan_refs[slot].used;
+    }
+    if (free_refs < count)
+    {
+        pthread_mutex_unlock(&host_lock);
+        return OCRE_ERROR_NO_MEMORY;
+    }
+    for (int i = 0, slot = 0; i < count; i++, slot++)
+    {
+        while (loan_refs[slot].used)
+        {
+            slot++;
+        }
+        mids[i] = __atomic_fetch_add(&next_mid, 1, __ATOMIC_RELAXED);
+        loan_refs[slot] = (native_loan_ref_t){.used = true, .mid = mids[i], .pool = pool, .index = buffer_index};
+    }
+    __atomic_add_fetch(&pool->refcount[buffer_index], (uint32_t)count, __ATOMIC_ACQ_REL);
+    pthread_mutex_unlock(&host_lock);
+
+    for (int i = 0; i < count; i++)
+    {
+        ocre_msg_t msg = {
+            .mid = mids[i],
+            .topic = topic,
+            .content_type = content_type,
+            .payload = pool->buffers[buffer_index],
+            .payload_len = payload_len,
+        };
+        handlers[i](&msg);
+    }
+    return OCRE_SUCCESS;
+}
+
+int ocre_release_message(uint32_t mid)
+{
+    int ret = OCRE_ERROR_NOT_FOUND;
+
+    pthread_mutex_lock(&host_lock);
+    for (size_t i = 0; i < sizeof(loan_refs) / sizeof(loan_refs[0]); i++)
+    {
+        native_loan_ref_t *ref = &loan_refs[i];
+        if (ref->used && ref->mid == mid)
+        {
+            // Return the reference to the producer's pool, never below zero
+            uint32_t *refcount = &ref->pool->refcount[ref->index];
+            uint32_t refs = __atomic_load_n(refcount, __ATOMIC_RELAXED);
+            while (refs > 0 &&
+                   !__atomic_compare_exchange_n(refcount, &refs, refs - 1, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            {
+            }
+            ref->used = false;
+            ret = OCRE_SUCCESS;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&host_lock);
+    return ret;
+}
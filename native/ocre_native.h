@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#ifndef OCRE_NATIVE_H
+#define OCRE_NATIVE_H
+
+#include "ocre_api.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // =============================================================================
+    // Native Host Emulation
+    // =============================================================================
+    //
+    // In-process implementation of the runtime side of ocre_api.h for native Linux
+    // builds (OCRE_NATIVE). Timers are POSIX timers, GPIO ports are simulated,
+    // sensors are scripted by the application and messages are delivered
+    // synchronously to handlers in the same process. The functions below let an
+    // application or benchmark drive the emulated hardware.
+
+    /**
+     * Scripted sensor source
+     * @param channel_type Channel being sampled
+     * @param timestamp_ns Sample time from ocre_native_time_ns()
+     * @param user_ctx Context pointer given to ocre_native_sensor_add()
+     * @return Channel value in micro-units
+     */
+    typedef ocre_sensor_value_t (*ocre_native_sensor_fn_t)(int channel_type, uint64_t timestamp_ns, void *user_ctx);
+
+    /**
+     * Message handler resolved by name for ocre_subscribe_message()
+     */
+    typedef void (*ocre_native_msg_handler_t)(ocre_msg_t *msg);
+
+    /**
+     * Monotonic time used by the emulated runtime
+     * @return Nanoseconds since an arbitrary epoch
+     */
+    uint64_t ocre_native_time_ns(void);
+
+    /**
+     * Queue an event as if raised by the runtime
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_BUSY if the event queue is full
+     */
+    int ocre_native_post_event(int32_t type, int32_t id, int32_t port, int32_t state);
+
+    /**
+     * Get the number of events waiting in the ring and the runtime queue
+     * @return Number of pending events
+     */
+    int ocre_native_pending_events(void);
+
+    /**
+     * Drive a simulated GPIO pin; if the level changed, records the edge when the pin
+     * is captured, or else raises a GPIO event if callbacks are enabled for it
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_native_gpio_input(int port, int pin, int state);
+
+    /**
+     * Add a scripted sensor
+     * @param name Sensor name used by the *_by_name functions
+     * @param channel_types Channel types provided by the sensor
+     * @param channel_count Number of channels
+     * @param fn Function producing channel values
+     * @param user_ctx Context pointer passed to @c fn
+     * @return Sensor ID on success, negative error code on failure
+     */
+    int ocre_native_sensor_add(const char *name, const int *channel_types, int channel_count,
+                               ocre_native_sensor_fn_t fn, void *user_ctx);
+
+    /**
+     * Make a message handler resolvable by name without relying on the dynamic symbol table
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_native_register_export(const char *name, ocre_native_msg_handler_t handler);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
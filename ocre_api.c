@@ -6,68 +6,239 @@
 #include <string.h>
 #include <stdlib.h>
 
-#define MAX_CALLBACKS 16
 #define BUTTON_PORT 2
+#define TIMER_CALLBACK_SLOTS (OCRE_MAX_TIMERS + 1) // Timer IDs run from 1 to OCRE_MAX_TIMERS
+#define GPIO_CALLBACK_SLOTS (CONFIG_OCRE_GPIO_MAX_PORTS * CONFIG_OCRE_GPIO_PINS_PER_PORT)
+
+// Flat dispatch table: timers, then GPIO pins by (port, pin), then sensors, channels and GPIO captures
+#define DISPATCH_GPIO_BASE TIMER_CALLBACK_SLOTS
+#define DISPATCH_SENSOR_BASE (DISPATCH_GPIO_BASE + GPIO_CALLBACK_SLOTS)
+#define DISPATCH_CHANNEL_BASE (DISPATCH_SENSOR_BASE + OCRE_MAX_SENSORS)
+#define DISPATCH_GPIO_CAPTURE_BASE (DISPATCH_CHANNEL_BASE + CONFIG_OCRE_CHANNEL_MAX)
+#define DISPATCH_SLOTS (DISPATCH_GPIO_CAPTURE_BASE + CONFIG_OCRE_GPIO_CAPTURE_MAX)
+
+// A NULL handler with @c legacy set marks a callback from ocre_register_*_callback()
+typedef struct
+{
+    ocre_event_handler_t handler;
+    union
+    {
+        void *user_ctx;
+        void (*legacy)(void);
+    };
+} dispatch_entry_t;
+
+static dispatch_entry_t dispatch_table[DISPATCH_SLOTS];
+static uint32_t dispatcher_enabled_mask = 0;
+
+static const char *const dispatcher_names[OCRE_RESOURCE_TYPE_COUNT] = {
+    [OCRE_RESOURCE_TYPE_TIMER] = "timer_callback",
+    [OCRE_RESOURCE_TYPE_GPIO] = "gpio_callback",
+    [OCRE_RESOURCE_TYPE_SENSOR] = "sensor_callback",
+    [OCRE_RESOURCE_TYPE_CHANNEL] = "channel_callback",
+    [OCRE_RESOURCE_TYPE_GPIO_CAPTURE] = "gpio_capture_callback",
+};
+
+// Map a (pin, port) pair to its GPIO slot, or -1 if out of range
+static inline int gpio_callback_slot(int pin, int port)
+{
+    if ((unsigned)port >= CONFIG_OCRE_GPIO_MAX_PORTS || (unsigned)pin >= CONFIG_OCRE_GPIO_PINS_PER_PORT)
+    {
+        return -1;
+    }
+    return port * CONFIG_OCRE_GPIO_PINS_PER_PORT + pin;
+}
+
+// Map a resource to its dispatch table slot, or -1 if out of range
+static int dispatch_slot(int type, int id, int port)
+{
+    switch (type)
+    {
+    case OCRE_RESOURCE_TYPE_TIMER:
+        return (unsigned)id < TIMER_CALLBACK_SLOTS ? id : -1;
+    case OCRE_RESOURCE_TYPE_GPIO:
+    {
+        int slot = gpio_callback_slot(id, port);
+        return slot < 0 ? -1 : DISPATCH_GPIO_BASE + slot;
+    }
+    case OCRE_RESOURCE_TYPE_SENSOR:
+        return (unsigned)id < OCRE_MAX_SENSORS ? DISPATCH_SENSOR_BASE + id : -1;
+    case OCRE_RESOURCE_TYPE_CHANNEL:
+        return (unsigned)id < CONFIG_OCRE_CHANNEL_MAX ? DISPATCH_CHANNEL_BASE + id : -1;
+    case OCRE_RESOURCE_TYPE_GPIO_CAPTURE:
+        return (unsigned)id < CONFIG_OCRE_GPIO_CAPTURE_MAX ? DISPATCH_GPIO_CAPTURE_BASE + id : -1;
+    default:
+        return -1;
+    }
+}
+
+static uint64_t monotonic_us(void)
+{
+    return ocre_clock_monotonic_ns() / 1000u;
+}
+
+// =============================================================================
+// SDK STATISTICS
+// =============================================================================
+
+#if CONFIG_OCRE_SDK_STATS
+static ocre_sdk_stats_t sdk_stats;
+#define STATS_INC(field) (sdk_stats.field++)
+#define STATS_ADD(field, n) (sdk_stats.field += (uint32_t)(n))
+
+static void stats_histogram_add(uint32_t *buckets, uint64_t us)
+{
+    int bucket = us ? 64 - __builtin_clzll(us) : 0;
+    buckets[bucket < OCRE_SDK_STATS_BUCKETS ? bucket : OCRE_SDK_STATS_BUCKETS - 1]++;
+}
+#else
+#define STATS_INC(field) ((void)0)
+#define STATS_ADD(field, n) ((void)0)
+#endif
+
+int ocre_sdk_stats_get(ocre_sdk_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+#if CONFIG_OCRE_SDK_STATS
+    *stats = sdk_stats;
+    return OCRE_SUCCESS;
+#else
+    memset(stats, 0, sizeof(*stats));
+    return OCRE_ERROR_NOT_FOUND;
+#endif
+}
 
-static void (*timer_callbacks[MAX_CALLBACKS])(void) = {0};
-static void (*gpio_callbacks[MAX_CALLBACKS])(void) = {0};
-static int gpio_callback_pins[MAX_CALLBACKS] = {-1};
-static int gpio_callback_ports[MAX_CALLBACKS] = {-1};
+void ocre_sdk_stats_reset(void)
+{
+#if CONFIG_OCRE_SDK_STATS
+    memset(&sdk_stats, 0, sizeof(sdk_stats));
+#endif
+}
 
-// Initialize callback pins to invalid values
-static void init_callback_system(void)
+// Log a histogram in two records of eight buckets so each fits a log line
+static void stats_log_histogram(const char *name, const uint32_t *buckets)
 {
-    static bool initialized = false;
-    if (!initialized)
+    for (int first = 0; first < OCRE_SDK_STATS_BUCKETS; first += 8)
     {
-        for (int i = 0; i < MAX_CALLBACKS; i++)
+        char line[128];
+        int len = snprintf(line, sizeof(line), "%s[%d..%d]:", name, first, first + 7);
+        for (int i = first; i < first + 8 && len < (int)sizeof(line); i++)
         {
-            gpio_callback_pins[i] = -1;
-            gpio_callback_ports[i] = -1; // Initialize ports to invalid
+            len += snprintf(line + len, sizeof(line) - (size_t)len, " %u", (unsigned)buckets[i]);
         }
-        initialized = true;
+        ocre_log_write(OCRE_LOG_LEVEL_NONE, "%s\n", line);
     }
 }
 
+OCRE_EXPORT("ocre_sdk_stats_dump") void ocre_sdk_stats_dump(void)
+{
+    static const char *const type_names[OCRE_RESOURCE_TYPE_COUNT] = {"timer", "gpio", "sensor", "channel", "capture"};
+    ocre_sdk_stats_t stats;
+
+    // Untagged records in the SDK log, written whatever the log level since they were asked for
+    if (ocre_sdk_stats_get(&stats) != OCRE_SUCCESS)
+    {
+        ocre_log_write(OCRE_LOG_LEVEL_NONE, "SDK statistics not enabled (CONFIG_OCRE_SDK_STATS)\n");
+        return;
+    }
+
+    ocre_log_write(OCRE_LOG_LEVEL_NONE, "%-8s %10s %10s %10s\n", "type", "retrieved", "dispatched", "unhandled");
+    for (int type = 0; type < OCRE_RESOURCE_TYPE_COUNT; type++)
+    {
+        ocre_log_write(OCRE_LOG_LEVEL_NONE, "%-8s %10u %10u %10u\n", type_names[type],
+                       (unsigned)stats.retrieved[type], (unsigned)stats.dispatched[type],
+                       (unsigned)stats.unhandled[type]);
+    }
+    ocre_log_write(OCRE_LOG_LEVEL_NONE, "invalid=%u coalesced=%u loops=%u idle_waits=%u loop_high_water=%u\n",
+                   (unsigned)stats.invalid, (unsigned)stats.coalesced, (unsigned)stats.loops,
+                   (unsigned)stats.idle_waits, (unsigned)stats.loop_high_water);
+    stats_log_histogram("callback_us", stats.callback_us);
+    stats_log_histogram("event_age_us", stats.event_age_us);
+}
+
 // =============================================================================
 // INTERNAL CALLBACK DISPATCHERS
 // =============================================================================
 
-__attribute__((export_name("timer_callback"))) void timer_callback(int timer_id)
+// Call the table entry for an event and wake the tasks awaiting it
+static void event_dispatch(const event_data_t *event)
 {
-    init_callback_system();
+    int slot = dispatch_slot(event->type, event->id, event->port);
+    const dispatch_entry_t *entry = slot >= 0 ? &dispatch_table[slot] : NULL;
+    bool handled = false;
 
-    if (timer_id >= 0 && timer_id < MAX_CALLBACKS && timer_callbacks[timer_id])
+    if (entry && entry->handler)
     {
-        printf("Executing timer callback for ID: %d\n", timer_id);
-        timer_callbacks[timer_id]();
+        entry->handler(event, entry->user_ctx);
+        handled = true;
     }
-    else
+    else if (entry && entry->legacy)
+    {
+        entry->legacy();
+        handled = true;
+    }
+
+    if (ocre_task_notify((ocre_resource_type_t)event->type, event->id, event->port, event->state) == 0 && !handled)
     {
-        printf("No timer callback registered for ID: %d\n", timer_id);
+        STATS_INC(unhandled[event->type]);
+        OCRE_LOG_WRN("No handler registered: type=%d, id=%d, port=%d\n", (int)event->type, (int)event->id,
+                     (int)event->port);
     }
 }
 
-__attribute__((export_name("gpio_callback"))) void gpio_callback(int pin, int state, int port)
+// Dispatch an event the SDK held back for debouncing or coalescing, counted like one taken from the queue. The
+// delivered level stands for several events, so it carries no timestamp.
+static void event_dispatch_deferred(int32_t type, int32_t id, int32_t port, int32_t state)
 {
-    init_callback_system();
+#if CONFIG_OCRE_SDK_STATS
+    uint64_t dispatch_start = monotonic_us();
+#endif
 
-    printf("GPIO event triggered: pin=%d, port=%d, state=%d\n", pin, port, state);
+    STATS_INC(dispatched[type]);
+    event_data_t event = {type, id, port, state, 0};
+    event_dispatch(&event);
 
-    for (int i = 0; i < MAX_CALLBACKS; i++)
-    {
-        if (gpio_callback_pins[i] == pin && gpio_callback_ports[i] == port && gpio_callbacks[i])
-        {
-            printf("Executing GPIO callback for pin: %d, port: %d\n", pin, port);
-            gpio_callbacks[i]();
-            return;
-        }
-    }
+#if CONFIG_OCRE_SDK_STATS
+    stats_histogram_add(sdk_stats.callback_us, monotonic_us() - dispatch_start);
+#endif
+}
+
+OCRE_EXPORT("timer_callback") void timer_callback(int timer_id)
+{
+    event_data_t event = {OCRE_RESOURCE_TYPE_TIMER, timer_id, 0, 0, 0};
+    event_dispatch(&event);
+}
+
+OCRE_EXPORT("gpio_callback") void gpio_callback(int pin, int state, int port)
+{
+    OCRE_LOG_DBG("GPIO event triggered: pin=%d, port=%d, state=%d\n", pin, port, state);
 
-    printf("No GPIO callback registered for pin: %d, port: %d\n", pin, port);
+    event_data_t event = {OCRE_RESOURCE_TYPE_GPIO, pin, port, state, 0};
+    event_dispatch(&event);
 }
 
-__attribute__((export_name("poll_events"))) void poll_events(void)
+OCRE_EXPORT("sensor_callback") void sensor_callback(int sensor_id)
+{
+    event_data_t event = {OCRE_RESOURCE_TYPE_SENSOR, sensor_id, 0, 0, 0};
+    event_dispatch(&event);
+}
+
+OCRE_EXPORT("channel_callback") void channel_callback(int channel_id)
+{
+    event_data_t event = {OCRE_RESOURCE_TYPE_CHANNEL, channel_id, 0, 0, 0};
+    event_dispatch(&event);
+}
+
+OCRE_EXPORT("gpio_capture_callback") void gpio_capture_callback(int capture_id, int pending)
+{
+    event_data_t event = {OCRE_RESOURCE_TYPE_GPIO_CAPTURE, capture_id, 0, pending, 0};
+    event_dispatch(&event);
+}
+
+OCRE_EXPORT("poll_events") void poll_events(void)
 {
     ocre_process_events();
 }
@@ -76,131 +247,540 @@ __attribute__((export_name("poll_events"))) void poll_events(void)
 // PUBLIC API FUNCTIONS
 // =============================================================================
 
-int ocre_register_timer_callback(int timer_id, timer_callback_func_t callback)
+int ocre_dispatcher_enable(ocre_resource_type_t type)
 {
-    // Register dispatchers
-    if (ocre_register_dispatcher(OCRE_RESOURCE_TYPE_TIMER, "timer_callback") != 0)
+    if ((unsigned)type >= OCRE_RESOURCE_TYPE_COUNT || dispatcher_names[type] == NULL)
     {
-        printf("Failed to register timer dispatcher\n");
-        return -1;
+        return OCRE_ERROR_INVALID;
+    }
+    if ((dispatcher_enabled_mask >> type) & 1u)
+    {
+        return OCRE_SUCCESS;
     }
 
-    init_callback_system();
+    int ret = ocre_register_dispatcher(type, dispatcher_names[type]);
+    if (ret != OCRE_SUCCESS)
+    {
+        OCRE_LOG_ERR("Failed to register %s dispatcher (%d)\n", dispatcher_names[type], ret);
+        return ret;
+    }
+
+    dispatcher_enabled_mask |= 1u << type;
+    return OCRE_SUCCESS;
+}
+
+// Fill a table slot and make sure its type is dispatched; the slot is left empty on failure
+static int dispatch_register(ocre_resource_type_t type, int slot, const dispatch_entry_t *entry)
+{
+    dispatch_table[slot] = *entry;
 
-    if (timer_id < 0 || timer_id >= MAX_CALLBACKS)
+    int ret = ocre_dispatcher_enable(type);
+    if (ret != OCRE_SUCCESS)
     {
-        printf("Error: Timer ID %d out of range (0-%d)\n", timer_id, MAX_CALLBACKS - 1);
+        dispatch_table[slot] = (dispatch_entry_t){0};
+    }
+    return ret;
+}
+
+int ocre_register_event_handler(ocre_resource_type_t type, int id, int port, ocre_event_handler_t handler,
+                                void *user_ctx)
+{
+    int slot = dispatch_slot(type, id, port);
+    if (slot < 0 || handler == NULL)
+    {
+        OCRE_LOG_ERR("Invalid event handler registration: type=%d, id=%d, port=%d\n", type, id, port);
+        return OCRE_ERROR_INVALID;
+    }
+
+    return dispatch_register(type, slot, &(dispatch_entry_t){.handler = handler, .user_ctx = user_ctx});
+}
+
+int ocre_unregister_event_handler(ocre_resource_type_t type, int id, int port)
+{
+    int slot = dispatch_slot(type, id, port);
+    if (slot < 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    if (dispatch_table[slot].handler == NULL && dispatch_table[slot].legacy == NULL)
+    {
+        return OCRE_ERROR_NOT_FOUND;
+    }
+
+    dispatch_table[slot] = (dispatch_entry_t){0};
+    return OCRE_SUCCESS;
+}
+
+int ocre_register_timer_callback(int timer_id, timer_callback_func_t callback)
+{
+    if (timer_id < 0 || timer_id >= TIMER_CALLBACK_SLOTS)
+    {
+        OCRE_LOG_ERR("Timer ID %d out of range (0-%d)\n", timer_id, TIMER_CALLBACK_SLOTS - 1);
         return -1;
     }
 
     if (callback == NULL)
     {
-        printf("Error: Timer callback is NULL for ID %d\n", timer_id);
+        OCRE_LOG_ERR("Timer callback is NULL for ID %d\n", timer_id);
         return -1;
     }
 
-    timer_callbacks[timer_id] = callback;
-    printf("Timer callback registered for ID: %d\n", timer_id);
+    if (dispatch_register(OCRE_RESOURCE_TYPE_TIMER, timer_id, &(dispatch_entry_t){.legacy = callback}) != 0)
+    {
+        return -1;
+    }
+    OCRE_LOG_INF("Timer callback registered for ID: %d\n", timer_id);
     return 0;
 }
 
 int ocre_register_gpio_callback(int pin, int port, gpio_callback_func_t callback)
 {
-    // Register dispatchers
-    if (ocre_register_dispatcher(OCRE_RESOURCE_TYPE_GPIO, "gpio_callback") != 0)
+    if (callback == NULL)
     {
-        printf("Failed to register GPIO dispatcher\n");
+        OCRE_LOG_ERR("GPIO callback is NULL for pin %d, port %d\n", pin, port);
         return -1;
     }
 
-    init_callback_system();
+    int slot = dispatch_slot(OCRE_RESOURCE_TYPE_GPIO, pin, port);
+    if (slot < 0)
+    {
+        OCRE_LOG_ERR("GPIO pin %d, port %d out of range\n", pin, port);
+        return -1;
+    }
 
-    if (callback == NULL)
+    if (dispatch_register(OCRE_RESOURCE_TYPE_GPIO, slot, &(dispatch_entry_t){.legacy = callback}) != 0)
     {
-        printf("Error: GPIO callback is NULL for pin %d, port %d\n", pin, port);
         return -1;
     }
+    OCRE_LOG_INF("GPIO callback registered for pin: %d, port: %d (slot %d)\n", pin, port, slot);
+    return 0;
+}
 
-    int slot = -1;
-    for (int i = 0; i < MAX_CALLBACKS; i++)
+int ocre_register_sensor_callback(int sensor_id, sensor_callback_func_t callback)
+{
+    if (sensor_id < 0 || sensor_id >= OCRE_MAX_SENSORS)
     {
-        if (gpio_callback_pins[i] == pin && gpio_callback_ports[i] == port)
-        {
-            slot = i; // Update existing
-            break;
-        }
-        if (slot == -1 && gpio_callback_pins[i] == -1)
-        {
-            slot = i; // Found empty slot
-        }
+        OCRE_LOG_ERR("Sensor ID %d out of range (0-%d)\n", sensor_id, OCRE_MAX_SENSORS - 1);
+        return -1;
     }
 
-    if (slot == -1)
+    if (callback == NULL)
     {
-        printf("Error: No available slots for GPIO callbacks\n");
+        OCRE_LOG_ERR("Sensor callback is NULL for ID %d\n", sensor_id);
         return -1;
     }
 
-    gpio_callback_pins[slot] = pin;
-    gpio_callback_ports[slot] = port;
-    gpio_callbacks[slot] = callback;
-    printf("GPIO callback registered for pin: %d, port: %d (slot %d)\n", pin, port, slot);
+    if (dispatch_register(OCRE_RESOURCE_TYPE_SENSOR, DISPATCH_SENSOR_BASE + sensor_id,
+                          &(dispatch_entry_t){.legacy = callback}) != 0)
+    {
+        return -1;
+    }
+    OCRE_LOG_INF("Sensor callback registered for ID: %d\n", sensor_id);
     return 0;
 }
 
 int ocre_unregister_timer_callback(int timer_id)
 {
-    init_callback_system();
+    if (timer_id < 0 || timer_id >= TIMER_CALLBACK_SLOTS)
+    {
+        return -1;
+    }
 
-    if (timer_id < 0 || timer_id >= MAX_CALLBACKS)
+    dispatch_table[timer_id] = (dispatch_entry_t){0};
+    OCRE_LOG_INF("Timer callback unregistered for ID: %d\n", timer_id);
+    return 0;
+}
+
+int ocre_unregister_sensor_callback(int sensor_id)
+{
+    if (sensor_id < 0 || sensor_id >= OCRE_MAX_SENSORS)
     {
         return -1;
     }
 
-    timer_callbacks[timer_id] = NULL;
-    printf("Timer callback unregistered for ID: %d\n", timer_id);
+    dispatch_table[DISPATCH_SENSOR_BASE + sensor_id] = (dispatch_entry_t){0};
+    OCRE_LOG_INF("Sensor callback unregistered for ID: %d\n", sensor_id);
     return 0;
 }
 
 int ocre_unregister_gpio_callback(int pin, int port)
 {
-    init_callback_system();
+    if (ocre_unregister_event_handler(OCRE_RESOURCE_TYPE_GPIO, pin, port) != OCRE_SUCCESS)
+    {
+        return -1; // Pin/port not found
+    }
+
+    OCRE_LOG_INF("GPIO callback unregistered for pin: %d, port: %d\n", pin, port);
+    return 0;
+}
+
+// =============================================================================
+// DEBOUNCE AND COALESCING
+// =============================================================================
+
+#define GPIO_MASK_WORDS ((GPIO_CALLBACK_SLOTS + 31) / 32)
+#define MASK_TEST(mask, bit) (((mask)[(bit) / 32] >> ((bit) % 32)) & 1u)
+#define MASK_SET(mask, bit) ((mask)[(bit) / 32] |= 1u << ((bit) % 32))
+#define MASK_CLEAR(mask, bit) ((mask)[(bit) / 32] &= ~(1u << ((bit) % 32)))
+
+_Static_assert(TIMER_CALLBACK_SLOTS <= 32, "timer coalescing masks hold at most 32 timers");
+
+typedef struct
+{
+    ocre_soft_timer_t timer;
+    bool active;
+    uint16_t slot;  // GPIO callback slot being debounced
+    uint8_t state;  // Latest level seen during the settle window
+} gpio_debounce_t;
+
+static uint32_t gpio_debounce_ms[GPIO_CALLBACK_SLOTS];
+static gpio_debounce_t gpio_debouncers[CONFIG_OCRE_GPIO_DEBOUNCE_SLOTS];
+static uint32_t gpio_coalesce_mask[GPIO_MASK_WORDS];
+static uint32_t gpio_pending_mask[GPIO_MASK_WORDS];  // Coalesced pins awaiting delivery
+static uint32_t gpio_pending_state[GPIO_MASK_WORDS];
+static uint32_t gpio_delivered_mask[GPIO_MASK_WORDS]; // Pins whose last delivered level is known
+static uint32_t gpio_delivered_state[GPIO_MASK_WORDS];
+static uint32_t timer_coalesce_mask = 0;
+static uint32_t timer_pending_mask = 0;
+
+// Deliver a settled or coalesced GPIO level unless it repeats the last level delivered
+static bool gpio_deliver_filtered(int slot, int state)
+{
+    if (MASK_TEST(gpio_delivered_mask, slot) && (int)MASK_TEST(gpio_delivered_state, slot) == state)
+    {
+        return false;
+    }
 
-    for (int i = 0; i < MAX_CALLBACKS; i++)
+    MASK_SET(gpio_delivered_mask, slot);
+    if (state)
     {
-        if (gpio_callback_pins[i] == pin && gpio_callback_ports[i] == port)
+        MASK_SET(gpio_delivered_state, slot);
+    }
+    else
+    {
+        MASK_CLEAR(gpio_delivered_state, slot);
+    }
+
+    event_dispatch_deferred(OCRE_RESOURCE_TYPE_GPIO, slot % CONFIG_OCRE_GPIO_PINS_PER_PORT,
+                            slot / CONFIG_OCRE_GPIO_PINS_PER_PORT, state);
+    return true;
+}
+
+static void gpio_debounce_expired(ocre_soft_timer_t *timer, void *user_ctx)
+{
+    gpio_debounce_t *debounce = user_ctx;
+    debounce->active = false;
+    gpio_deliver_filtered(debounce->slot, debounce->state);
+}
+
+static gpio_debounce_t *gpio_debounce_find(int slot, bool allocate)
+{
+    gpio_debounce_t *free_entry = NULL;
+
+    for (int i = 0; i < CONFIG_OCRE_GPIO_DEBOUNCE_SLOTS; i++)
+    {
+        if (gpio_debouncers[i].active && gpio_debouncers[i].slot == slot)
+        {
+            return &gpio_debouncers[i];
+        }
+        if (!gpio_debouncers[i].active && free_entry == NULL)
         {
-            gpio_callback_pins[i] = -1;
-            gpio_callback_ports[i] = -1;
-            gpio_callbacks[i] = NULL;
-            printf("GPIO callback unregistered for pin: %d, port: %d\n", pin, port);
-            return 0;
+            free_entry = &gpio_debouncers[i];
         }
     }
 
-    return -1; // Pin/port not found
+    if (!allocate || free_entry == NULL)
+    {
+        return NULL;
+    }
+
+    ocre_soft_timer_init(&free_entry->timer, gpio_debounce_expired, free_entry);
+    free_entry->active = true;
+    free_entry->slot = (uint16_t)slot;
+    return free_entry;
 }
 
-void ocre_process_events(void)
+// Start or restart the settle window for a pin; false if the event must be delivered directly
+static bool gpio_debounce_event(int slot, int state)
+{
+    gpio_debounce_t *debounce = gpio_debounce_find(slot, true);
+    if (debounce == NULL)
+    {
+        OCRE_LOG_WRN("No free debounce slot, delivering GPIO slot %d directly\n", slot);
+        return false;
+    }
+
+    debounce->state = (uint8_t)state;
+    if (ocre_soft_timer_start(&debounce->timer, gpio_debounce_ms[slot], 0) != OCRE_SUCCESS)
+    {
+        debounce->active = false;
+        return false;
+    }
+    return true;
+}
+
+// Take over events that are debounced or coalesced; returns true if the event was absorbed
+static bool event_absorb(const event_data_t *event)
+{
+    if (event->type == OCRE_RESOURCE_TYPE_TIMER && event->port == 0 && event->id < TIMER_CALLBACK_SLOTS &&
+        (timer_coalesce_mask >> event->id) & 1u)
+    {
+        timer_pending_mask |= 1u << event->id;
+        return true;
+    }
+
+    if (event->type != OCRE_RESOURCE_TYPE_GPIO)
+    {
+        return false;
+    }
+
+    int slot = gpio_callback_slot(event->id, event->port);
+    if (slot < 0)
+    {
+        return false;
+    }
+
+    if (gpio_debounce_ms[slot] > 0)
+    {
+        return gpio_debounce_event(slot, event->state);
+    }
+
+    if (MASK_TEST(gpio_coalesce_mask, slot))
+    {
+        MASK_SET(gpio_pending_mask, slot);
+        if (event->state)
+        {
+            MASK_SET(gpio_pending_state, slot);
+        }
+        else
+        {
+            MASK_CLEAR(gpio_pending_state, slot);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+// Deliver the coalesced timer expiries and GPIO levels collected during one processing pass
+static int event_flush_coalesced(void)
+{
+    int delivered = 0;
+
+    while (timer_pending_mask)
+    {
+        int timer_id = __builtin_ctz(timer_pending_mask);
+        timer_pending_mask &= timer_pending_mask - 1;
+        event_dispatch_deferred(OCRE_RESOURCE_TYPE_TIMER, timer_id, 0, 0);
+        delivered++;
+    }
+
+    for (int word = 0; word < GPIO_MASK_WORDS; word++)
+    {
+        while (gpio_pending_mask[word])
+        {
+            int slot = word * 32 + __builtin_ctz(gpio_pending_mask[word]);
+            gpio_pending_mask[word] &= gpio_pending_mask[word] - 1;
+            delivered += gpio_deliver_filtered(slot, MASK_TEST(gpio_pending_state, slot));
+        }
+    }
+
+    return delivered;
+}
+
+int ocre_gpio_set_debounce(int pin, int port, uint32_t debounce_ms)
+{
+    int slot = gpio_callback_slot(pin, port);
+    if (slot < 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    gpio_debounce_ms[slot] = debounce_ms;
+    if (debounce_ms == 0)
+    {
+        gpio_debounce_t *debounce = gpio_debounce_find(slot, false);
+        if (debounce)
+        {
+            ocre_soft_timer_stop(&debounce->timer);
+            debounce->active = false;
+        }
+    }
+    return OCRE_SUCCESS;
+}
+
+int ocre_gpio_set_coalesce(int pin, int port, bool latest_only)
+{
+    int slot = gpio_callback_slot(pin, port);
+    if (slot < 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    if (latest_only)
+    {
+        MASK_SET(gpio_coalesce_mask, slot);
+    }
+    else
+    {
+        MASK_CLEAR(gpio_coalesce_mask, slot);
+    }
+    return OCRE_SUCCESS;
+}
+
+int ocre_timer_set_coalesce(int timer_id, bool coalesce)
+{
+    if (timer_id < 0 || timer_id >= TIMER_CALLBACK_SLOTS)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    if (coalesce)
+    {
+        timer_coalesce_mask |= 1u << timer_id;
+    }
+    else
+    {
+        timer_coalesce_mask &= ~(1u << timer_id);
+    }
+    return OCRE_SUCCESS;
+}
+
+// =============================================================================
+// EVENT RETRIEVAL
+// =============================================================================
+
+_Static_assert((CONFIG_OCRE_EVENT_RING_SIZE & (CONFIG_OCRE_EVENT_RING_SIZE - 1)) == 0,
+               "CONFIG_OCRE_EVENT_RING_SIZE must be a power of two");
+
+static ocre_event_ring_t event_ring;
+static bool event_ring_enabled = false;
+
+int ocre_event_ring_enable(void)
+{
+    if (event_ring_enabled)
+    {
+        return OCRE_SUCCESS;
+    }
+
+    memset(&event_ring, 0, sizeof(event_ring));
+    event_ring.version = OCRE_EVENT_RING_VERSION;
+    event_ring.capacity = CONFIG_OCRE_EVENT_RING_SIZE;
+
+    int ret = ocre_register_event_ring(&event_ring, CONFIG_OCRE_EVENT_RING_SIZE);
+    if (ret != OCRE_SUCCESS)
+    {
+        OCRE_LOG_WRN("Event ring not supported by runtime (%d), using ocre_get_event\n", ret);
+        return ret;
+    }
+
+    event_ring_enabled = true;
+    return OCRE_SUCCESS;
+}
+
+// Pop the oldest event from the shared ring without crossing into the runtime
+static bool event_ring_pop(event_data_t *event)
+{
+    uint32_t tail = event_ring.tail;
+    uint32_t head = __atomic_load_n(&event_ring.head, __ATOMIC_ACQUIRE);
+
+    if (head == tail)
+    {
+        return false;
+    }
+
+    *event = event_ring.events[tail & (CONFIG_OCRE_EVENT_RING_SIZE - 1)];
+    __atomic_store_n(&event_ring.tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Fetch the next pending event, from the ring if enabled, otherwise from the runtime
+static bool next_event(event_data_t *event)
+{
+    if (event_ring_enabled)
+    {
+        if (event_ring_pop(event))
+        {
+            return true;
+        }
+
+        // Ring is drained; only ask the runtime if it spilled events into its own queue
+        if (__atomic_load_n(&event_ring.overflow, __ATOMIC_ACQUIRE) == 0)
+        {
+            return false;
+        }
+    }
+
+    // Get the base address of event as an offset in WASM memory
+    uintptr_t base_offset = (uintptr_t)event;
+    uintptr_t type_offset = base_offset + offsetof(event_data_t, type);
+    uintptr_t id_offset = base_offset + offsetof(event_data_t, id);
+    uintptr_t port_offset = base_offset + offsetof(event_data_t, port);
+    uintptr_t state_offset = base_offset + offsetof(event_data_t, state);
+
+    if (ocre_get_event(type_offset, id_offset, port_offset, state_offset) != 0)
+    {
+        return false;
+    }
+
+    event->timestamp_ns = 0; // ocre_get_event() does not report when the event occurred
+    return true;
+}
+
+// Number of events still pending, or -1 if the runtime holds events the SDK cannot count
+static int32_t pending_events(void)
+{
+    if (!event_ring_enabled || __atomic_load_n(&event_ring.overflow, __ATOMIC_ACQUIRE) != 0)
+    {
+        return -1;
+    }
+    return (int32_t)(__atomic_load_n(&event_ring.head, __ATOMIC_ACQUIRE) - event_ring.tail);
+}
+
+// Wait for the next event, falling back to a fixed sleep on runtimes without ocre_wait_events
+static void wait_for_events(void)
+{
+    static bool wait_supported = true;
+
+    STATS_INC(idle_waits);
+
+    if (wait_supported)
+    {
+        int ret = ocre_wait_events(CONFIG_OCRE_EVENT_WAIT_TIMEOUT_MS);
+        if (ret == OCRE_SUCCESS || ret == OCRE_ERROR_TIMEOUT)
+        {
+            return;
+        }
+
+        OCRE_LOG_WRN("ocre_wait_events not supported by runtime (%d), using ocre_sleep\n", ret);
+        wait_supported = false;
+    }
+
+    ocre_sleep(CONFIG_OCRE_EVENT_IDLE_SLEEP_MS);
+}
+
+int ocre_process_events_ex(int max_events, uint32_t max_us, ocre_event_loop_result_t *result)
 {
     event_data_t event_data;
     int event_count = 0;
-    const int max_events_per_loop = 5;
+    int absorbed = 0;
+    int taken = 0;
+    uint64_t deadline_us = max_us ? monotonic_us() + max_us : 0;
 
-    // Get the base address of event_data as an offset in WASM memory
-    uint32_t base_offset = (uint32_t)&event_data;
-    uint32_t type_offset = base_offset + offsetof(event_data_t, type);
-    uint32_t id_offset = base_offset + offsetof(event_data_t, id);
-    uint32_t port_offset = base_offset + offsetof(event_data_t, port);
-    uint32_t state_offset = base_offset + offsetof(event_data_t, state);
-
-    while (event_count < max_events_per_loop)
+    // Debounced and coalesced events do not use up the budget, but are capped so a storm cannot stall the loop.
+    // Malformed events count against both budgets like dispatched ones.
+    while ((max_events <= 0 || taken - absorbed < max_events) && absorbed < CONFIG_OCRE_EVENT_COALESCE_LIMIT)
     {
-        int ret = ocre_get_event(type_offset, id_offset, port_offset, state_offset);
-        if (ret != 0)
+        if (deadline_us && taken && monotonic_us() >= deadline_us)
+        {
+            break;
+        }
+
+        if (!next_event(&event_data))
         {
             break;
         }
+        taken++;
 
         // Access event data
         int32_t type = event_data.type;
@@ -213,30 +793,79 @@ void ocre_process_events(void)
             (type == OCRE_RESOURCE_TYPE_GPIO && state != OCRE_GPIO_PIN_SET &&
              state != OCRE_GPIO_PIN_RESET))
         {
-            printf("Invalid event: type=%d, id=%d, port=%d, state=%d\n", type, id, port, state);
+            STATS_INC(invalid);
+            OCRE_LOG_WRN("Invalid event: type=%d, id=%d, port=%d, state=%d\n", type, id, port, state);
             continue;
         }
 
-        printf("Retrieved event: type=%d, id=%d, port=%d, state=%d\n", type, id, port, state);
+        STATS_INC(retrieved[type]);
 
-        // Dispatch events
-        if (type == OCRE_RESOURCE_TYPE_TIMER && port == 0)
+        OCRE_LOG_DBG("Retrieved event: type=%d, id=%d, port=%d, state=%d\n", type, id, port, state);
+
+        if (event_absorb(&event_data))
         {
-            timer_callback(id);
+            absorbed++;
+            continue;
         }
-        else if (type == OCRE_RESOURCE_TYPE_GPIO)
+
+#if CONFIG_OCRE_SDK_STATS
+        uint64_t dispatch_start = monotonic_us();
+        if (event_data.timestamp_ns && event_data.timestamp_ns / 1000u <= dispatch_start)
+        {
+            stats_histogram_add(sdk_stats.event_age_us, dispatch_start - event_data.timestamp_ns / 1000u);
+        }
+#endif
+
+        // Dispatch events
+        if (type == OCRE_RESOURCE_TYPE_TIMER && port != 0)
         {
-            gpio_callback(id, state, port);
+            STATS_INC(unhandled[type]);
+            OCRE_LOG_WRN("Unknown event: type=%d, id=%d, port=%d, state=%d\n", type, id, port, state);
         }
         else
         {
-            printf("Unknown event: type=%d, id=%d, port=%d, state=%d\n", type, id, port, state);
+            STATS_INC(dispatched[type]);
+            event_dispatch(&event_data);
         }
         event_count++;
+
+#if CONFIG_OCRE_SDK_STATS
+        stats_histogram_add(sdk_stats.callback_us, monotonic_us() - dispatch_start);
+#endif
     }
 
-    if (event_count == 0)
+    event_count += event_flush_coalesced();
+
+    // Run the tasks woken by this batch
+    ocre_task_run();
+
+    STATS_INC(loops);
+    STATS_ADD(coalesced, absorbed);
+#if CONFIG_OCRE_SDK_STATS
+    if ((uint32_t)taken > sdk_stats.loop_high_water)
+    {
+        sdk_stats.loop_high_water = (uint32_t)taken;
+    }
+#else
+    (void)taken;
+#endif
+
+    if (result)
+    {
+        result->processed = (uint32_t)event_count;
+        result->coalesced = (uint32_t)absorbed;
+        result->remaining = pending_events();
+    }
+    return event_count;
+}
+
+void ocre_process_events(void)
+{
+    ocre_event_loop_result_t result;
+
+    ocre_process_events_ex(CONFIG_OCRE_EVENTS_PER_LOOP, 0, &result);
+    if (result.processed == 0 && result.coalesced == 0 && !ocre_task_ready())
     {
-        ocre_sleep(10);
+        wait_for_events();
     }
 }
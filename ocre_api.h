@@ -18,7 +18,25 @@ extern "C"
 #endif
 
 // For exported callback functions (optional - only needed for WASM callbacks)
+#if defined(__wasm__)
 #define OCRE_EXPORT(name) __attribute__((export_name(name)))
+#else
+// Native builds resolve exports by symbol name, so the name must match the function's. Each name is also recorded in
+// the "ocre_exports" section; the native host checks at startup that every recorded name resolves.
+#define OCRE_EXPORT_CONCAT_(a, b) a##b
+#define OCRE_EXPORT_CONCAT(a, b) OCRE_EXPORT_CONCAT_(a, b)
+#define OCRE_EXPORT(name)                                                                                             \
+    static const char *const OCRE_EXPORT_CONCAT(ocre_export_name_, __COUNTER__)                                       \
+        __attribute__((section("ocre_exports"), used)) = name;                                                       \
+    __attribute__((visibility("default"), used))
+#endif
+
+// For SDK wrappers that call a runtime function of the same name under a different C name
+#if defined(__wasm__)
+#define OCRE_IMPORT(name) __attribute__((import_module("env"), import_name(name)))
+#else
+#define OCRE_IMPORT(name)
+#endif
 
 // OCRE SDK Version Information
 #define OCRE_SDK_VERSION_MAJOR 1
@@ -40,6 +58,7 @@ extern "C"
 #define OCRE_MAX_CALLBACKS 64
 #define OCRE_MAX_TOPIC_LEN 128
 #define OCRE_MAX_PAYLOAD_LEN 1024
+#define OCRE_MAX_CONTENT_TYPE_LEN 64
 #define CONFIG_MAX_SENSOR_NAME_LENGTH 125
 
 #define OCRE_API_POSIX_BUF_SIZE 65
@@ -55,6 +74,152 @@ extern "C"
 
 #ifndef CONFIG_OCRE_GPIO_PINS_PER_PORT
 #define CONFIG_OCRE_GPIO_PINS_PER_PORT 16
+#endif
+
+// Event Ring Configuration (must be a power of two)
+#ifndef CONFIG_OCRE_EVENT_RING_SIZE
+#define CONFIG_OCRE_EVENT_RING_SIZE 32
+#endif
+
+#define OCRE_EVENT_RING_VERSION 2
+
+#define OCRE_TIME_PAGE_VERSION 1
+
+// Loaned Message Buffer Configuration
+#ifndef CONFIG_OCRE_MSG_LOAN_BUFFERS
+#define CONFIG_OCRE_MSG_LOAN_BUFFERS 4
+#endif
+
+#ifndef CONFIG_OCRE_MSG_LOAN_BUFFER_SIZE
+#define CONFIG_OCRE_MSG_LOAN_BUFFER_SIZE 2048
+#endif
+
+#define OCRE_MSG_POOL_VERSION 1
+
+// Memory Pool Configuration
+#ifndef CONFIG_OCRE_POOL_MAX_BLOCKS
+#define CONFIG_OCRE_POOL_MAX_BLOCKS 128
+#endif
+
+// Topic Router Configuration
+#ifndef CONFIG_OCRE_MSG_ROUTER_MAX_ROUTES
+#define CONFIG_OCRE_MSG_ROUTER_MAX_ROUTES 16
+#endif
+
+#ifndef CONFIG_OCRE_MSG_ROUTER_MAX_NODES
+#define CONFIG_OCRE_MSG_ROUTER_MAX_NODES 64
+#endif
+
+// Message Filter Configuration
+#ifndef CONFIG_OCRE_MSG_FILTER_MAX_PREDICATES
+#define CONFIG_OCRE_MSG_FILTER_MAX_PREDICATES 4
+#endif
+
+#define OCRE_MSG_FILTER_VERSION 1
+
+// Channel Configuration
+#ifndef CONFIG_OCRE_CHANNEL_MAX
+#define CONFIG_OCRE_CHANNEL_MAX 4
+#endif
+
+#define OCRE_MAX_CHANNEL_NAME_LEN 32
+#define OCRE_CHANNEL_VERSION 1
+
+// Sensor Stream Configuration (depth must be a power of two)
+#ifndef CONFIG_OCRE_SENSOR_STREAM_MAX_CHANNELS
+#define CONFIG_OCRE_SENSOR_STREAM_MAX_CHANNELS 8
+#endif
+
+#ifndef CONFIG_OCRE_SENSOR_STREAM_DEPTH
+#define CONFIG_OCRE_SENSOR_STREAM_DEPTH 32
+#endif
+
+#define OCRE_SENSOR_STREAM_VERSION 1
+
+// GPIO Edge Capture Configuration (depth must be a power of two)
+#ifndef CONFIG_OCRE_GPIO_CAPTURE_MAX
+#define CONFIG_OCRE_GPIO_CAPTURE_MAX 4
+#endif
+
+#ifndef CONFIG_OCRE_GPIO_CAPTURE_DEPTH
+#define CONFIG_OCRE_GPIO_CAPTURE_DEPTH 64
+#endif
+
+#define OCRE_GPIO_CAPTURE_VERSION 1
+
+// Sensor Name Cache Configuration
+#ifndef CONFIG_OCRE_SENSOR_CACHE_SIZE
+#define CONFIG_OCRE_SENSOR_CACHE_SIZE 8
+#endif
+
+#ifndef CONFIG_OCRE_SENSOR_CACHE_MAX_CHANNELS
+#define CONFIG_OCRE_SENSOR_CACHE_MAX_CHANNELS 8
+#endif
+
+// Sensor Aggregation Configuration
+#ifndef CONFIG_OCRE_SENSOR_AGG_WINDOW_MAX
+#define CONFIG_OCRE_SENSOR_AGG_WINDOW_MAX 32
+#endif
+
+// Soft Timer Configuration
+#ifndef CONFIG_OCRE_SOFT_TIMER_HOST_ID
+#define CONFIG_OCRE_SOFT_TIMER_HOST_ID OCRE_MAX_TIMERS
+#endif
+
+#ifndef CONFIG_OCRE_SOFT_TIMER_TICK_MS
+#define CONFIG_OCRE_SOFT_TIMER_TICK_MS 1
+#endif
+
+// Log Levels
+#define OCRE_LOG_LEVEL_NONE 0
+#define OCRE_LOG_LEVEL_ERR 1
+#define OCRE_LOG_LEVEL_WRN 2
+#define OCRE_LOG_LEVEL_INF 3
+#define OCRE_LOG_LEVEL_DBG 4
+
+// Log Configuration
+#ifndef CONFIG_OCRE_LOG_LEVEL
+#define CONFIG_OCRE_LOG_LEVEL OCRE_LOG_LEVEL_WRN
+#endif
+
+// Size of the in-memory log ring in bytes (must be a power of two)
+#ifndef CONFIG_OCRE_LOG_BUFFER_SIZE
+#define CONFIG_OCRE_LOG_BUFFER_SIZE 2048
+#endif
+
+// Longest time ocre_process_events() blocks in ocre_wait_events() when idle
+#ifndef CONFIG_OCRE_EVENT_WAIT_TIMEOUT_MS
+#define CONFIG_OCRE_EVENT_WAIT_TIMEOUT_MS 100
+#endif
+
+// Idle sleep used when the runtime does not provide ocre_wait_events()
+#ifndef CONFIG_OCRE_EVENT_IDLE_SLEEP_MS
+#define CONFIG_OCRE_EVENT_IDLE_SLEEP_MS 10
+#endif
+
+// Event budget of ocre_process_events(); see ocre_process_events_ex() for other budgets
+#ifndef CONFIG_OCRE_EVENTS_PER_LOOP
+#define CONFIG_OCRE_EVENTS_PER_LOOP 5
+#endif
+
+// Event loop and dispatch statistics (ocre_sdk_stats_get()); 0 compiles them out
+#ifndef CONFIG_OCRE_SDK_STATS
+#define CONFIG_OCRE_SDK_STATS 0
+#endif
+
+// Messages held by the SDK message pool (ocre_msg_alloc(), ocre_msg_copy())
+#ifndef CONFIG_OCRE_MSG_BUFFER_COUNT
+#define CONFIG_OCRE_MSG_BUFFER_COUNT 4
+#endif
+
+// Most coalesced or debounced events ocre_process_events() absorbs per call
+#ifndef CONFIG_OCRE_EVENT_COALESCE_LIMIT
+#define CONFIG_OCRE_EVENT_COALESCE_LIMIT CONFIG_OCRE_EVENT_RING_SIZE
+#endif
+
+// Number of GPIO pins that can be settling in a debounce window at the same time
+#ifndef CONFIG_OCRE_GPIO_DEBOUNCE_SLOTS
+#define CONFIG_OCRE_GPIO_DEBOUNCE_SLOTS 8
 #endif
 
     // Internal state tracking
@@ -67,13 +232,18 @@ extern "C"
 
     /**
      * Structure for event data
+     *
+     * Only events read from the shared event ring carry a timestamp. Events from
+     * ocre_get_event(), direct runtime callbacks and debounced or coalesced
+     * deliveries have timestamp_ns set to 0.
      */
     typedef struct
     {
-        int32_t type;  /**< Resource type (e.g., OCRE_RESOURCE_TYPE_*) */
-        int32_t id;    /**< Resource ID */
-        int32_t port;  /**< Port number (for GPIO) */
-        int32_t state; /**< State (e.g., pin state for GPIO) */
+        int32_t type;          /**< Resource type (e.g., OCRE_RESOURCE_TYPE_*) */
+        int32_t id;            /**< Resource ID */
+        int32_t port;          /**< Port number (for GPIO) */
+        int32_t state;         /**< State (e.g., pin state for GPIO) */
+        uint64_t timestamp_ns; /**< When the event occurred, on the ocre_clock_monotonic_ns() base; 0 if unknown */
     } event_data_t;
 
     // =============================================================================
@@ -88,6 +258,8 @@ extern "C"
         OCRE_RESOURCE_TYPE_TIMER,
         OCRE_RESOURCE_TYPE_GPIO,
         OCRE_RESOURCE_TYPE_SENSOR,
+        OCRE_RESOURCE_TYPE_CHANNEL,
+        OCRE_RESOURCE_TYPE_GPIO_CAPTURE,
         OCRE_RESOURCE_TYPE_COUNT
     } ocre_resource_type_t;
 
@@ -132,6 +304,76 @@ extern "C"
      */
     int ocre_timer_get_remaining(int id);
 
+    /**
+     * Soft timer
+     *
+     * Soft timers are multiplexed by the SDK onto the single runtime timer
+     * CONFIG_OCRE_SOFT_TIMER_HOST_ID through a hierarchical timing wheel (4 levels of
+     * 64 slots, CONFIG_OCRE_SOFT_TIMER_TICK_MS per tick). Any number of them can be
+     * active; start and stop are O(1), and the runtime timer is only reprogrammed
+     * when the earliest deadline moves earlier. Expiry callbacks run from
+     * ocre_process_events(). The structure is owned by the caller and must stay
+     * valid while the timer is active; its fields are internal.
+     */
+    typedef struct ocre_soft_timer ocre_soft_timer_t;
+
+    /**
+     * Soft timer expiry function type
+     * @param timer Expired timer
+     * @param user_ctx Context pointer given to ocre_soft_timer_init()
+     */
+    typedef void (*ocre_soft_timer_func_t)(ocre_soft_timer_t *timer, void *user_ctx);
+
+    struct ocre_soft_timer
+    {
+        ocre_soft_timer_t *next;      /**< Next timer in the wheel slot */
+        ocre_soft_timer_t **pprev;    /**< Link pointing at this timer, NULL when inactive */
+        uint32_t expires;             /**< Expiry in wheel ticks */
+        uint32_t period;              /**< Reload in wheel ticks, 0 for one-shot */
+        uint8_t level;                /**< Wheel level holding the timer */
+        uint8_t slot;                 /**< Slot within @c level */
+        ocre_soft_timer_func_t func;  /**< Expiry function */
+        void *user_ctx;               /**< Context passed to @c func */
+    };
+
+    /**
+     * Initialize a soft timer
+     * @param timer Timer to initialize
+     * @param func Function called on expiry
+     * @param user_ctx Context pointer passed to @c func
+     */
+    void ocre_soft_timer_init(ocre_soft_timer_t *timer, ocre_soft_timer_func_t func, void *user_ctx);
+
+    /**
+     * Start or restart a soft timer
+     * @param timer Initialized timer
+     * @param timeout_ms Time to first expiry in milliseconds
+     * @param period_ms Reload interval in milliseconds, 0 for a one-shot timer
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_soft_timer_start(ocre_soft_timer_t *timer, uint32_t timeout_ms, uint32_t period_ms);
+
+    /**
+     * Stop a soft timer; stopping an inactive timer is not an error
+     * @param timer Timer to stop
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_soft_timer_stop(ocre_soft_timer_t *timer);
+
+    /**
+     * Check whether a soft timer is running
+     * @param timer Timer to check
+     * @return true if the timer is active
+     */
+    bool ocre_soft_timer_is_active(const ocre_soft_timer_t *timer);
+
+    /**
+     * Get the time until a soft timer next expires
+     * @param timer Timer to query
+     * @return Remaining time in milliseconds, 0 if the timer is not active
+     */
+    uint32_t ocre_soft_timer_remaining(const ocre_soft_timer_t *timer);
+
     // =============================================================================
     // GPIO API
     // =============================================================================
@@ -210,203 +452,1759 @@ extern "C"
      */
     int ocre_gpio_unregister_callback(int port, int pin);
 
-    // =============================================================================
-    // Messages API
-    // =============================================================================
+    /**
+     * Bit mask covering the pins of one GPIO port; bit n is pin n
+     */
+    typedef uint32_t ocre_gpio_port_mask_t;
+
+#ifdef __cplusplus
+    static_assert(CONFIG_OCRE_GPIO_PINS_PER_PORT <= 32, "ocre_gpio_port_mask_t holds at most 32 pins");
+#else
+    _Static_assert(CONFIG_OCRE_GPIO_PINS_PER_PORT <= 32, "ocre_gpio_port_mask_t holds at most 32 pins");
+#endif
+
+#define OCRE_GPIO_PIN_MASK(pin) ((ocre_gpio_port_mask_t)1u << (pin))
+#define OCRE_GPIO_PORT_ALL_PINS                                                   \
+    ((ocre_gpio_port_mask_t)(CONFIG_OCRE_GPIO_PINS_PER_PORT >= 32                 \
+                                 ? 0xFFFFFFFFu                                    \
+                                 : ((1u << CONFIG_OCRE_GPIO_PINS_PER_PORT) - 1u)))
 
     /**
-     * Structure of ocre messages
+     * Read the state of all pins of a GPIO port in one call
+     * @param port GPIO port number
+     * @param mask Receives the pin states, bit n set if pin n is high
+     * @return 0 on success, negative error code on failure
      */
-    typedef struct ocre_msg
-    {
-        uint32_t mid;         /**< message id - increments on each message */
-        char *topic;          /**< url of the request */
-        char *content_type;   /**< payload format (MIME type) */
-        void *payload;        /**< payload of the request */
-        uint32_t payload_len; /**< length in bytes of the payload */
-    } ocre_msg_t;
+    int ocre_gpio_port_get(int port, ocre_gpio_port_mask_t *mask);
 
     /**
-     * Initialize OCRE Messaging System
+     * Set the selected pins of a GPIO port atomically
+     * @param port GPIO port number
+     * @param mask Pins to change
+     * @param value New states for the pins in @c mask; other bits are ignored
+     * @return 0 on success, negative error code on failure
      */
-    void ocre_msg_system_init(void);
+    int ocre_gpio_port_set_masked(int port, ocre_gpio_port_mask_t mask, ocre_gpio_port_mask_t value);
 
     /**
-     * Publish a message to the specified target
-     * @param topic the name of the topic on which to publish the message
-     * @param content_type the content type of the message; it is recommended to use a MIME type
-     * @param payload a buffer containing the message contents
-     * @param payload_len the length of the payload buffer
+     * Toggle the selected pins of a GPIO port atomically
+     * @param port GPIO port number
+     * @param mask Pins to toggle
      * @return 0 on success, negative error code on failure
      */
-    int ocre_publish_message(char *topic, char *content_type, void *payload, int payload_len);
+    int ocre_gpio_port_toggle(int port, ocre_gpio_port_mask_t mask);
 
     /**
-     * Subscribe to messages on the specified topic
-     * @param topic the name of the topic on which to subscribe
-     * @param handler_name name of callback function that will be called when a message is received on this topic
+     * Configure the direction of several pins of a GPIO port in one call
+     * @param port GPIO port number
+     * @param mask Pins to configure
+     * @param direction Pin direction (input/output)
      * @return 0 on success, negative error code on failure
      */
-    int ocre_subscribe_message(char *topic, char *handler_name);
+    int ocre_gpio_configure_mask(int port, ocre_gpio_port_mask_t mask, int direction);
+
+    // =============================================================================
+    // GPIO Edge Capture API
+    // =============================================================================
 
     /**
-     * Register a new WASM module instance
-     * @param module_inst WASM module instance to register
+     * Edges recorded by a capture
      */
-    void ocre_messaging_register_module(wasm_module_inst_t module_inst);
+    typedef enum
+    {
+        OCRE_GPIO_EDGE_RISING = 1,
+        OCRE_GPIO_EDGE_FALLING = 2,
+        OCRE_GPIO_EDGE_BOTH = 3
+    } ocre_gpio_edge_mode_t;
 
     /**
-     * Cleans up all subscriptions associated with a WASM module instance
-     * @param module_inst WASM module instance to clean up
+     * One captured edge
      */
-    void ocre_messaging_cleanup_container(wasm_module_inst_t module_inst);
+    typedef struct
+    {
+        uint64_t timestamp_ns; /**< Time of the edge, on the ocre_clock_monotonic_ns() base */
+        uint32_t state;        /**< Pin level after the edge */
+        uint32_t reserved;
+    } ocre_gpio_edge_t;
 
-    // =============================================================================
-    // Event API
-    // =============================================================================
+    /**
+     * GPIO edge capture ring
+     *
+     * Single-producer/single-consumer ring in guest linear memory. The host
+     * timestamps each selected edge of the pin, writes it and advances @c head; the
+     * guest is the only writer of @c tail. Both indices increase monotonically and
+     * are reduced modulo @c capacity. When the ring is full the host drops the new
+     * edge and increments @c dropped.
+     */
+    typedef struct
+    {
+        uint32_t version;  /**< Layout version, OCRE_GPIO_CAPTURE_VERSION */
+        uint32_t capacity; /**< Number of slots in @c edges */
+        uint32_t head;     /**< Producer index, written by the host */
+        uint32_t tail;     /**< Consumer index, written by the guest */
+        uint32_t dropped;  /**< Edges lost because the ring was full */
+        int32_t id;        /**< Capture ID (guest bookkeeping) */
+        int32_t port;      /**< Captured GPIO port (guest bookkeeping) */
+        int32_t pin;       /**< Captured GPIO pin (guest bookkeeping) */
+        int32_t edge_mode; /**< Selected ocre_gpio_edge_mode_t (guest bookkeeping) */
+        ocre_gpio_edge_t edges[CONFIG_OCRE_GPIO_CAPTURE_DEPTH]; /**< Edge slots */
+    } ocre_gpio_capture_t;
 
     /**
-     * Timer callback function type
+     * Start recording the edges of an input pin into a guest ring
+     *
+     * Captured edges do not raise OCRE_RESOURCE_TYPE_GPIO events of their own.
+     * Instead the runtime queues one OCRE_RESOURCE_TYPE_GPIO_CAPTURE event, with
+     * id set to the capture ID and state to the number of unread edges, after
+     * every @p notify_every edges, or @p window_ms after the first edge not yet
+     * notified, whichever comes first.
+     * @param port GPIO port number
+     * @param pin GPIO pin number
+     * @param edges ocre_gpio_edge_mode_t selecting the edges to record
+     * @param notify_every Number of edges between notifications; 0 to notify by window only
+     * @param window_ms Longest delay of a notification in milliseconds; 0 to notify by count only
+     * @param capture Edge ring located in guest linear memory
+     * @return Capture ID below CONFIG_OCRE_GPIO_CAPTURE_MAX on success, negative error code on failure
      */
-    typedef void (*timer_callback_func_t)(void);
+    int ocre_gpio_capture_start(int port, int pin, int edges, int notify_every, int window_ms,
+                                ocre_gpio_capture_t *capture);
 
     /**
-     * GPIO callback function type
+     * Stop recording edges
+     * @param capture_id Capture ID from ocre_gpio_capture_start()
+     * @return OCRE_SUCCESS on success, negative error code on failure
      */
-    typedef void (*gpio_callback_func_t)(void);
+    int ocre_gpio_capture_stop(int capture_id);
 
     /**
-     * Get event data for a specific resource
-     * @param type_offset Offset for resource type
-     * @param id_offset Offset for resource ID
-     * @param port_offset Offset for port number
-     * @param state_offset Offset for state
+     * Initialize an edge ring and start capturing a pin into it
+     *
+     * Register a handler for OCRE_RESOURCE_TYPE_GPIO_CAPTURE with @c capture->id to
+     * be notified when edges are available. The pin must be configured as an input.
+     * @param capture Edge ring to initialize; must stay valid until closed
+     * @param port GPIO port number
+     * @param pin GPIO pin number
+     * @param edges ocre_gpio_edge_mode_t selecting the edges to record
+     * @param notify_every Number of edges between notifications, at most CONFIG_OCRE_GPIO_CAPTURE_DEPTH;
+     *                     0 to notify by window only
+     * @param window_ms Longest delay of a notification in milliseconds; 0 to notify by count only
      * @return OCRE_SUCCESS on success, negative error code on failure
      */
-    int ocre_get_event(uint32_t type_offset, uint32_t id_offset, uint32_t port_offset,
-                       uint32_t state_offset);
+    int ocre_gpio_capture_open(ocre_gpio_capture_t *capture, int port, int pin, ocre_gpio_edge_mode_t edges,
+                               int notify_every, int window_ms);
 
     /**
-     * Process the events from runtime
+     * Stop capturing; unread edges remain readable
+     * @param capture Edge ring passed to ocre_gpio_capture_open()
+     * @return OCRE_SUCCESS on success, negative error code on failure
      */
-    void ocre_process_events(void);
+    int ocre_gpio_capture_close(ocre_gpio_capture_t *capture);
 
     /**
-     * Unregister GPIO callback
-     * @param pin GPIO pin number
-     * @param port GPIO port number
-     * @return 0 on success, negative error code on failure
+     * Get the number of unread edges
+     * @param capture Edge ring
+     * @return Number of edges available
      */
-    int ocre_unregister_gpio_callback(int pin, int port);
+    int ocre_gpio_capture_available(const ocre_gpio_capture_t *capture);
 
     /**
-     * Unregister timer callback
-     * @param timer_id Timer identifier
-     * @return 0 on success, negative error code on failure
+     * Copy and consume edges from a capture
+     * @param capture Edge ring
+     * @param edges Destination array
+     * @param max_edges Capacity of @c edges
+     * @return Number of edges copied, negative error code on failure
      */
-    int ocre_unregister_timer_callback(int timer_id);
+    int ocre_gpio_capture_read(ocre_gpio_capture_t *capture, ocre_gpio_edge_t *edges, int max_edges);
 
     /**
-     * Register GPIO callback
-     * @param pin GPIO pin number
-     * @param port GPIO port number
-     * @param callback Callback function to register
-     * @return 0 on success, negative error code on failure
+     * Pulse measurement state carried across batches of captured edges
+     *
+     * Pulses are counted and timed on rising edges, or on falling edges for an
+     * OCRE_GPIO_EDGE_FALLING capture; the "rise" fields then refer to falling edges.
+     * Pulse widths and the duty cycle need OCRE_GPIO_EDGE_BOTH. Edges lost to a full
+     * ring (see @c dropped of the capture) skew the results until the next reset.
      */
-    int ocre_register_gpio_callback(int pin, int port, gpio_callback_func_t callback);
+    typedef struct
+    {
+        uint64_t first_rise_ns; /**< First counted edge since reset */
+        uint64_t last_rise_ns;  /**< Latest counted edge */
+        uint64_t last_edge_ns;  /**< Latest edge of either polarity */
+        uint64_t period_ns;     /**< Latest interval between counted edges; 0 until two counted edges */
+        uint64_t high_ns;       /**< Width of the latest complete high pulse */
+        uint64_t low_ns;        /**< Width of the latest complete low phase */
+        uint32_t pulses;        /**< Counted edges since reset */
+        int32_t level;          /**< Level after the latest edge; -1 before the first edge */
+    } ocre_gpio_pulse_t;
 
     /**
-     * Register timer callback
-     * @param timer_id Timer identifier
-     * @param callback Callback function to register
-     * @return 0 on success, negative error code on failure
+     * Clear pulse measurements, e.g. at the start of a counting window
+     * @param pulse Measurement state
      */
-    int ocre_register_timer_callback(int timer_id, timer_callback_func_t callback);
+    void ocre_gpio_pulse_reset(ocre_gpio_pulse_t *pulse);
 
-    // =============================================================================
-    // Utility API
-    // =============================================================================
+    /**
+     * Consume captured edges into pulse measurements
+     *
+     * With @p widths_us, the time spent at each level between consecutive edges is
+     * also decoded, e.g. for IR receivers: positive for high and negative for low.
+     * Consumption then stops when @p widths_us is full, so no width is lost.
+     * @param capture Edge ring
+     * @param pulse Measurement state
+     * @param widths_us Receives level durations in microseconds; may be NULL
+     * @param max_widths Capacity of @p widths_us
+     * @return Number of edges consumed, negative error code on failure
+     */
+    int ocre_gpio_pulse_update(ocre_gpio_capture_t *capture, ocre_gpio_pulse_t *pulse, int32_t *widths_us,
+                               int max_widths);
 
     /**
-     * Sleep for specified duration
-     * @param milliseconds Sleep duration in milliseconds
-     * @return OCRE_SUCCESS on success, error code on failure
+     * Get the mean frequency of the counted edges since reset
+     * @param pulse Measurement state
+     * @return Frequency in millihertz, 0 until two counted edges
      */
-    int ocre_sleep(int milliseconds);
+    uint32_t ocre_gpio_pulse_frequency_mhz(const ocre_gpio_pulse_t *pulse);
 
-/**
- * Pause execution indefinitely (implementation-specific)
- * @return OCRE_SUCCESS on success, error code on failure
- */
-#define ocre_pause() ocre_sleep(9999999)
+    /**
+     * Get the duty cycle of the latest complete pulse
+     * @param pulse Measurement state
+     * @return High time in per mille of the period, 0 until a high and a low phase are measured
+     */
+    uint32_t ocre_gpio_pulse_duty_permille(const ocre_gpio_pulse_t *pulse);
 
     // =============================================================================
-    // Sensor API
+    // Memory Pool API
     // =============================================================================
 
     /**
-     * Sensor handle type
+     * Fixed-block memory pool
+     *
+     * Hands out equal-sized blocks from caller-provided static storage with O(1)
+     * allocation and release, so long-running containers never fragment the heap or
+     * grow linear memory. Exhaustion is reported deterministically. While a block is
+     * free its first pointer-sized bytes hold the free-list link. A pool holds at most
+     * CONFIG_OCRE_POOL_MAX_BLOCKS blocks. Fields are internal.
      */
-    typedef int ocre_sensor_handle_t;
+    typedef struct
+    {
+        uint8_t *storage;     /**< First block */
+        uint32_t block_size;  /**< Bytes per block */
+        uint32_t block_count; /**< Number of blocks */
+        void *free_list;      /**< Next free block */
+        uint32_t in_use;      /**< Blocks currently allocated */
+        uint32_t high_water;  /**< Most blocks allocated at once */
+        uint32_t failures;    /**< Allocations refused because the pool was empty */
+        uint32_t allocated[(CONFIG_OCRE_POOL_MAX_BLOCKS + 31) / 32]; /**< Bit per block currently allocated */
+    } ocre_pool_t;
 
     /**
-     * Initialize the sensor system
-     * @return 0 on success
+     * Pool usage statistics
      */
-    int ocre_sensors_init(void);
+    typedef struct
+    {
+        uint32_t block_size;  /**< Bytes per block */
+        uint32_t block_count; /**< Number of blocks */
+        uint32_t in_use;      /**< Blocks currently allocated */
+        uint32_t high_water;  /**< Most blocks allocated at once */
+        uint32_t failures;    /**< Allocations refused because the pool was empty */
+    } ocre_pool_stats_t;
 
     /**
-     * Discover available sensors
-     * @return Number of discovered sensors, negative error code on failure
+     * Initialize a pool over static storage
+     * @param pool Pool to initialize
+     * @param storage Storage for the blocks, aligned for the objects they will hold
+     * @param storage_size Size of @p storage in bytes
+     * @param block_size Block size, a non-zero multiple of sizeof(void *)
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_INVALID on bad arguments or more than
+     *         CONFIG_OCRE_POOL_MAX_BLOCKS blocks
      */
-    int ocre_sensors_discover(void);
+    int ocre_pool_init(ocre_pool_t *pool, void *storage, size_t storage_size, size_t block_size);
 
     /**
-     * Open a sensor for use
-     * @param handle Handle of the sensor to open
-     * @return 0 on success, negative error code on failure
+     * Allocate a block
+     * @param pool Initialized pool
+     * @param block Receives the block, uninitialized
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_NO_MEMORY if the pool is empty
      */
-    int ocre_sensors_open(ocre_sensor_handle_t handle);
+    int ocre_pool_alloc(ocre_pool_t *pool, void **block);
 
     /**
-     * Get the handle of a sensor
-     * @param sensor_id ID of the sensor
-     * @return Sensor handle on success, negative error code on failure
+     * Return a block to its pool
+     * @param pool Pool the block came from
+     * @param block Block to release
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_INVALID if @p block is not a block of @p pool
+     *         or is not currently allocated
      */
-    int ocre_sensors_get_handle(int sensor_id);
+    int ocre_pool_free(ocre_pool_t *pool, void *block);
 
     /**
-     * Get the number of channels available in a sensor
-     * @param sensor_id ID of the sensor
-     * @return Number of channels on success, negative error code on failure
+     * Get the index of a block within its pool
+     * @return Block index, or OCRE_ERROR_INVALID if @p block is not a block of @p pool
      */
-    int ocre_sensors_get_channel_count(int sensor_id);
+    int ocre_pool_index(const ocre_pool_t *pool, const void *block);
 
     /**
-     * Get the type of a specific sensor channel
-     * @param sensor_id ID of the sensor
-     * @param channel_index Index of the channel
-     * @return Channel type on success, negative error code on failure
+     * Get pool usage statistics
+     * @param pool Initialized pool
+     * @param stats Filled with the current statistics
+     * @return OCRE_SUCCESS on success, negative error code on failure
      */
-    int ocre_sensors_get_channel_type(int sensor_id, int channel_index);
+    int ocre_pool_get_stats(const ocre_pool_t *pool, ocre_pool_stats_t *stats);
+
+    // =============================================================================
+    // Messages API
+    // =============================================================================
 
     /**
-     * Read data from a sensor channel
-     * @param sensor_id ID of the sensor
-     * @param channel_type Type of the channel to read
-     * @return Sensor value in integer format, negative error code on failure
+     * Structure of ocre messages
      */
-    int ocre_sensors_read(int sensor_id, int channel_type);
+    typedef struct ocre_msg
+    {
+        uint32_t mid;         /**< message id - increments on each message */
+        char *topic;          /**< url of the request */
+        char *content_type;   /**< payload format (MIME type) */
+        void *payload;        /**< payload of the request */
+        uint32_t payload_len; /**< length in bytes of the payload */
+    } ocre_msg_t;
 
     /**
-     * Get the handle of a sensor by name
-     * @param sensor_name Name of the sensor
-     * @return OCRE_SUCCESS on success, negative error code on failure
+     * Initialize OCRE Messaging System
      */
-    int ocre_sensors_get_handle_by_name(const char *sensor_name);
+    void ocre_msg_system_init(void);
 
     /**
-     * Open a sensor by name
+     * Publish a message to the specified target
+     * @param topic the name of the topic on which to publish the message
+     * @param content_type the content type of the message; it is recommended to use a MIME type
+     * @param payload a buffer containing the message contents
+     * @param payload_len the length of the payload buffer
+     * @return 0 on success, negative error code on failure
+     */
+    int ocre_publish_message(char *topic, char *content_type, void *payload, int payload_len);
+
+    /**
+     * Subscribe to messages on the specified topic
+     * @param topic the name of the topic on which to subscribe
+     * @param handler_name name of callback function that will be called when a message is received on this topic
+     * @return 0 on success, negative error code on failure
+     */
+    int ocre_subscribe_message(char *topic, char *handler_name);
+
+    /**
+     * Remove a subscription made with ocre_subscribe_message() or ocre_subscribe_message_filtered()
+     * @param topic the topic given when subscribing
+     * @param handler_name the callback function name given when subscribing
+     * @return 0 on success, OCRE_ERROR_NOT_FOUND if there is no such subscription, negative error code on failure
+     */
+    int ocre_unsubscribe_message(char *topic, char *handler_name);
+
+    /**
+     * Comparison of a message filter predicate
+     */
+    typedef enum
+    {
+        OCRE_MSG_PRED_EQ,
+        OCRE_MSG_PRED_NE,
+        OCRE_MSG_PRED_LT,
+        OCRE_MSG_PRED_GT
+    } ocre_msg_pred_op_t;
+
+// Or'ed into a predicate op: the field is stored least significant byte first
+#define OCRE_MSG_PRED_LITTLE_ENDIAN 0x80
+#define OCRE_MSG_PRED_MAX_LEN 8
+
+    /**
+     * Predicate on a fixed payload field
+     *
+     * The field's bytes and @c value are both ANDed with @c mask, read as unsigned
+     * integers in the field's byte order (big-endian unless
+     * OCRE_MSG_PRED_LITTLE_ENDIAN is set) and compared as field op value. A payload
+     * too short to hold the field fails the predicate.
+     */
+    typedef struct
+    {
+        uint16_t offset;                      /**< First payload byte of the field */
+        uint8_t len;                          /**< Field length in bytes, 1 to OCRE_MSG_PRED_MAX_LEN */
+        uint8_t op;                           /**< ocre_msg_pred_op_t, optionally with OCRE_MSG_PRED_LITTLE_ENDIAN */
+        uint8_t value[OCRE_MSG_PRED_MAX_LEN]; /**< Operand, in the field's byte order */
+        uint8_t mask[OCRE_MSG_PRED_MAX_LEN];  /**< Bits of the field that take part */
+    } ocre_msg_predicate_t;
+
+// Deliver only the newest of the messages held back by the rate limit once the interval ends
+#define OCRE_MSG_FILTER_LATEST_ONLY 0x1
+
+    /**
+     * Declarative subscription filter evaluated by the runtime before delivery
+     *
+     * A message is delivered if its content type matches and all predicates hold,
+     * and then at most @c max_rate_hz times per second. Without
+     * OCRE_MSG_FILTER_LATEST_ONLY, messages over the rate are dropped; with it, the
+     * latest one is held and delivered when the interval ends, so the subscriber
+     * always ends up with the current value. Like every delivery, the held message
+     * reaches the handler on the container's own thread, the next time it enters the
+     * runtime (e.g. ocre_process_events() waiting for events).
+     */
+    typedef struct
+    {
+        uint32_t version;                             /**< Layout version, OCRE_MSG_FILTER_VERSION */
+        uint32_t flags;                               /**< OCRE_MSG_FILTER_* flags */
+        uint32_t max_rate_hz;                         /**< Most deliveries per second; 0 for no limit */
+        uint32_t predicate_count;                     /**< Number of valid entries in @c predicates */
+        char content_type[OCRE_MAX_CONTENT_TYPE_LEN]; /**< Required content type; empty for any */
+        ocre_msg_predicate_t predicates[CONFIG_OCRE_MSG_FILTER_MAX_PREDICATES]; /**< All must hold */
+    } ocre_msg_filter_t;
+
+    /**
+     * Subscribe to messages on the specified topic through a filter
+     *
+     * Messages rejected by the filter never reach the container, which saves a
+     * call into the guest per message. The filter is copied by the runtime.
+     * @param topic the name of the topic on which to subscribe
+     * @param handler_name name of callback function that will be called when a message is received on this topic
+     * @param filter Filter initialized with ocre_msg_filter_init()
+     * @return 0 on success, negative error code on failure
+     */
+    int ocre_subscribe_message_filtered(char *topic, char *handler_name, const ocre_msg_filter_t *filter);
+
+    /**
+     * Initialize a filter that accepts every message
+     * @param filter Filter to initialize
+     */
+    void ocre_msg_filter_init(ocre_msg_filter_t *filter);
+
+    /**
+     * Require a content type
+     * @param filter Initialized filter
+     * @param content_type Content type to match exactly, shorter than OCRE_MAX_CONTENT_TYPE_LEN; NULL or
+     *                     empty for any
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_INVALID if the content type is too long
+     */
+    int ocre_msg_filter_content_type(ocre_msg_filter_t *filter, const char *content_type);
+
+    /**
+     * Add a predicate on a payload field
+     * @param filter Initialized filter
+     * @param offset First payload byte of the field
+     * @param len Field length in bytes, 1 to OCRE_MSG_PRED_MAX_LEN
+     * @param op ocre_msg_pred_op_t, optionally with OCRE_MSG_PRED_LITTLE_ENDIAN
+     * @param value Operand as an unsigned integer
+     * @param mask Bits of the field that take part, e.g. UINT64_MAX for all
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_NO_MEMORY if
+     *         CONFIG_OCRE_MSG_FILTER_MAX_PREDICATES are in use, OCRE_ERROR_INVALID on bad arguments
+     */
+    int ocre_msg_filter_add_predicate(ocre_msg_filter_t *filter, uint32_t offset, uint32_t len, int op,
+                                      uint64_t value, uint64_t mask);
+
+    /**
+     * Check a message against the content type and predicates of a filter
+     *
+     * The rate limit is applied by the runtime only. Handlers can use this to
+     * filter on runtimes without ocre_subscribe_message_filtered().
+     * @param filter Filter to evaluate
+     * @param msg Message to check
+     * @return true if the message passes
+     */
+    bool ocre_msg_filter_match(const ocre_msg_filter_t *filter, const ocre_msg_t *msg);
+
+    /**
+     * Shared pool of loaned message buffers
+     *
+     * Lives in guest linear memory and is registered once with the runtime. A buffer
+     * is free while its reference count is zero. The producer holds one reference
+     * from ocre_msg_loan() until publish; the runtime takes one reference per
+     * delivery and drops it when the subscriber, possibly in another container,
+     * calls ocre_msg_release(). Reference counts are only modified with atomic
+     * operations and never drop below zero.
+     */
+    typedef struct
+    {
+        uint32_t version;      /**< Layout version, OCRE_MSG_POOL_VERSION */
+        uint32_t buffer_count; /**< Number of buffers */
+        uint32_t buffer_size;  /**< Size of each buffer in bytes */
+        uint32_t refcount[CONFIG_OCRE_MSG_LOAN_BUFFERS]; /**< References held per buffer */
+        uint8_t buffers[CONFIG_OCRE_MSG_LOAN_BUFFERS][CONFIG_OCRE_MSG_LOAN_BUFFER_SIZE]
+            __attribute__((aligned(8))); /**< Payload storage */
+    } ocre_msg_pool_t;
+
+    /**
+     * A message buffer on loan to the producer
+     */
+    typedef struct
+    {
+        int32_t index;     /**< Buffer index in the pool, negative if not loaned */
+        void *data;        /**< Writable payload storage */
+        uint32_t capacity; /**< Usable size of @c data in bytes */
+    } ocre_msg_loan_t;
+
+    /**
+     * Register the loaned buffer pool with the runtime
+     * @param pool Pool located in guest linear memory
+     * @return OCRE_SUCCESS on success, negative error code if unsupported or invalid
+     */
+    int ocre_msg_pool_register(ocre_msg_pool_t *pool);
+
+    /**
+     * Publish a message whose payload is already in a registered pool buffer
+     * @param topic the name of the topic on which to publish the message
+     * @param content_type the content type of the message; it is recommended to use a MIME type
+     * @param buffer_index index of the pool buffer holding the payload
+     * @param payload_len the length of the payload
+     * @return 0 on success, OCRE_ERROR_NO_MEMORY without delivering to anyone if the
+     *         runtime cannot take a reference for every subscriber, other negative error
+     *         code on failure
+     */
+    int ocre_publish_message_loaned(char *topic, char *content_type, uint32_t buffer_index,
+                                    uint32_t payload_len);
+
+    /**
+     * Drop the reference a loaned delivery holds on the producer's pool buffer
+     *
+     * The runtime records the producer pool and buffer of each loaned delivery by
+     * message ID, so the reference is returned to the pool that owns it.
+     * @param mid ID of the delivered message
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_NOT_FOUND if the message is not an
+     *         outstanding loaned delivery
+     */
+    int ocre_release_message(uint32_t mid);
+
+    /**
+     * Borrow a buffer from the shared pool to build a message payload in place
+     * @param size Number of payload bytes required
+     * @param loan Receives the loaned buffer
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_INVALID if size exceeds
+     *         CONFIG_OCRE_MSG_LOAN_BUFFER_SIZE, or OCRE_MAX_PAYLOAD_LEN on runtimes
+     *         without pool support, OCRE_ERROR_NO_MEMORY if all buffers are in use
+     */
+    int ocre_msg_loan(uint32_t size, ocre_msg_loan_t *loan);
+
+    /**
+     * Publish a loaned buffer without copying it and hand it back to the pool
+     *
+     * Subscribers receive ocre_msg_t views into the same buffer. On runtimes without
+     * pool support the payload is published with ocre_publish_message() instead.
+     * The loan is consumed whether or not publishing succeeds.
+     * @param loan Loan obtained from ocre_msg_loan()
+     * @param topic the name of the topic on which to publish the message
+     * @param content_type the content type of the message
+     * @param payload_len Number of bytes written to @c loan->data
+     * @return 0 on success, negative error code on failure
+     */
+    int ocre_msg_publish_loaned(ocre_msg_loan_t *loan, char *topic, char *content_type,
+                                uint32_t payload_len);
+
+    /**
+     * Return a loaned buffer to the pool without publishing it
+     * @param loan Loan obtained from ocre_msg_loan()
+     */
+    void ocre_msg_loan_cancel(ocre_msg_loan_t *loan);
+
+    /**
+     * Release a received message
+     *
+     * Drops the subscriber's reference to the producer's pool buffer through
+     * ocre_release_message(). Messages that are not loaned deliveries are ignored
+     * by the runtime, so handlers may call this unconditionally. Route handlers
+     * (ocre_msg_route_add()) must not call it: the router releases each delivery
+     * after the last matching route returns.
+     * @param msg Message passed to the subscriber handler
+     */
+    void ocre_msg_release(const ocre_msg_t *msg);
+
+    /**
+     * Topic router handler type
+     *
+     * The router owns the delivery: the handler must not call ocre_msg_release(), and
+     * copies the message (ocre_msg_copy()) if it needs it after returning.
+     * @param msg Received message; valid only for the duration of the call
+     * @param user_ctx Context pointer given to ocre_msg_route_add()
+     */
+    typedef void (*ocre_msg_handler_t)(const ocre_msg_t *msg, void *user_ctx);
+
+    /**
+     * Route messages matching a topic filter to a C handler
+     *
+     * Filters use MQTT syntax: '+' matches exactly one topic level and a trailing
+     * '#' matches the parent level and any number of levels below it. Wildcards
+     * do not match topics starting with '$'. Any number of routes may share a
+     * filter. All routes are served by the single exported entry point
+     * "ocre_msg_router", which the runtime calls with an ocre_msg_t pointer. The
+     * runtime is subscribed once per distinct literal prefix (the filter up to its
+     * first wildcard level, without the '/' before a trailing '#'). It is expected
+     * to deliver every topic that starts with that prefix, and the router does the
+     * exact matching. A prefix that covers earlier, narrower ones replaces them
+     * through ocre_unsubscribe_message(), so each message is routed once.
+     * @param filter Topic filter, shorter than OCRE_MAX_TOPIC_LEN
+     * @param handler Function called for each matching message
+     * @param user_ctx Context pointer passed to @c handler
+     * @return Route ID (>= 0) on success, OCRE_ERROR_INVALID for a malformed filter,
+     *         OCRE_ERROR_NO_MEMORY when CONFIG_OCRE_MSG_ROUTER_MAX_ROUTES or
+     *         CONFIG_OCRE_MSG_ROUTER_MAX_NODES is exhausted
+     */
+    int ocre_msg_route_add(const char *filter, ocre_msg_handler_t handler, void *user_ctx);
+
+    /**
+     * Remove a route
+     * @param route_id Route ID returned by ocre_msg_route_add()
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_NOT_FOUND if no such route
+     */
+    int ocre_msg_route_remove(int route_id);
+
+    /**
+     * Deliver a message to every route whose filter matches its topic
+     * @param msg Message to dispatch
+     * @return Number of handlers invoked
+     */
+    int ocre_msg_route_dispatch(const ocre_msg_t *msg);
+
+    /**
+     * Get usage statistics of the router's route pool
+     * (CONFIG_OCRE_MSG_ROUTER_MAX_ROUTES records)
+     * @param stats Filled with the current statistics
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_msg_route_stats(ocre_pool_stats_t *stats);
+
+    /**
+     * Allocate a message from the SDK message pool
+     *
+     * The message's topic, content_type and payload point into the same pool block,
+     * sized OCRE_MAX_TOPIC_LEN, OCRE_MAX_CONTENT_TYPE_LEN and OCRE_MAX_PAYLOAD_LEN.
+     * The pool holds CONFIG_OCRE_MSG_BUFFER_COUNT messages.
+     * @param msg Receives the message, with empty strings and payload_len 0
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_NO_MEMORY if the pool is exhausted
+     */
+    int ocre_msg_alloc(ocre_msg_t **msg);
+
+    /**
+     * Copy a message into the SDK message pool so it outlives its delivery
+     * @param msg Message to copy, e.g. one passed to a message handler
+     * @param copy Receives the copy
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_NO_MEMORY if the pool is exhausted,
+     *         OCRE_ERROR_INVALID if a field exceeds the pool's limits
+     */
+    int ocre_msg_copy(const ocre_msg_t *msg, ocre_msg_t **copy);
+
+    /**
+     * Return a message from ocre_msg_alloc() or ocre_msg_copy() to the pool
+     * @param msg Message to release
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_INVALID if @p msg is not from the pool
+     */
+    int ocre_msg_free(ocre_msg_t *msg);
+
+    /**
+     * Get usage statistics of the SDK message pool
+     * @param stats Filled with the current statistics
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_msg_buffer_stats(ocre_pool_stats_t *stats);
+
+    /**
+     * Register a new WASM module instance
+     * @param module_inst WASM module instance to register
+     */
+    void ocre_messaging_register_module(wasm_module_inst_t module_inst);
+
+    /**
+     * Cleans up all subscriptions and channels associated with a WASM module instance
+     * @param module_inst WASM module instance to clean up
+     */
+    void ocre_messaging_cleanup_container(wasm_module_inst_t module_inst);
+
+    // =============================================================================
+    // CBOR API
+    // =============================================================================
+    //
+    // Streaming CBOR (RFC 8949) encoder and decoder for message payloads. The
+    // encoder writes into a caller-supplied buffer and the decoder reads
+    // ocre_msg_t.payload in place; neither allocates. Only definite-length items are
+    // produced and accepted.
+
+#define OCRE_CONTENT_TYPE_CBOR "application/cbor"
+
+    /**
+     * CBOR encoder state
+     *
+     * Errors are sticky: after the first failure every call returns the same error,
+     * so a sequence of calls can be checked once at the end.
+     */
+    typedef struct
+    {
+        uint8_t *buf; /**< Output buffer */
+        size_t size;  /**< Size of @c buf */
+        size_t len;   /**< Bytes written */
+        int error;    /**< First error, OCRE_SUCCESS if none */
+    } ocre_cbor_writer_t;
+
+    /**
+     * CBOR item types
+     */
+    typedef enum
+    {
+        OCRE_CBOR_UINT,
+        OCRE_CBOR_NEGINT, /**< Negative integer, value in @c i */
+        OCRE_CBOR_BYTES,
+        OCRE_CBOR_TEXT,
+        OCRE_CBOR_ARRAY,
+        OCRE_CBOR_MAP,
+        OCRE_CBOR_TAG,
+        OCRE_CBOR_BOOL,
+        OCRE_CBOR_NULL,
+        OCRE_CBOR_UNDEFINED,
+        OCRE_CBOR_FLOAT,
+    } ocre_cbor_type_t;
+
+    /**
+     * Decoded CBOR item; strings point into the decoded buffer
+     */
+    typedef struct
+    {
+        ocre_cbor_type_t type;
+        union
+        {
+            uint64_t u;     /**< OCRE_CBOR_UINT, OCRE_CBOR_TAG */
+            int64_t i;      /**< OCRE_CBOR_NEGINT */
+            double f;       /**< OCRE_CBOR_FLOAT */
+            bool b;         /**< OCRE_CBOR_BOOL */
+            uint64_t count; /**< OCRE_CBOR_ARRAY elements, OCRE_CBOR_MAP pairs */
+            struct
+            {
+                const uint8_t *ptr;
+                size_t len;
+            } str;          /**< OCRE_CBOR_BYTES, OCRE_CBOR_TEXT (not NUL-terminated) */
+        } v;
+    } ocre_cbor_item_t;
+
+    /**
+     * CBOR decoder state
+     */
+    typedef struct
+    {
+        const uint8_t *buf; /**< Input buffer */
+        size_t size;        /**< Size of @c buf */
+        size_t pos;         /**< Offset of the next item */
+    } ocre_cbor_reader_t;
+
+    /**
+     * Start encoding into a buffer
+     */
+    void ocre_cbor_writer_init(ocre_cbor_writer_t *writer, void *buf, size_t size);
+
+    /**
+     * Encode an unsigned integer
+     * @return OCRE_SUCCESS, or OCRE_ERROR_NO_MEMORY if the buffer is full
+     */
+    int ocre_cbor_put_uint(ocre_cbor_writer_t *writer, uint64_t value);
+
+    /**
+     * Encode a signed integer
+     * @return OCRE_SUCCESS, or OCRE_ERROR_NO_MEMORY if the buffer is full
+     */
+    int ocre_cbor_put_int(ocre_cbor_writer_t *writer, int64_t value);
+
+    /**
+     * Encode a floating-point number, as single precision when that is exact
+     * @return OCRE_SUCCESS, or OCRE_ERROR_NO_MEMORY if the buffer is full
+     */
+    int ocre_cbor_put_float(ocre_cbor_writer_t *writer, double value);
+
+    /**
+     * Encode a boolean
+     * @return OCRE_SUCCESS, or OCRE_ERROR_NO_MEMORY if the buffer is full
+     */
+    int ocre_cbor_put_bool(ocre_cbor_writer_t *writer, bool value);
+
+    /**
+     * Encode null
+     * @return OCRE_SUCCESS, or OCRE_ERROR_NO_MEMORY if the buffer is full
+     */
+    int ocre_cbor_put_null(ocre_cbor_writer_t *writer);
+
+    /**
+     * Encode a UTF-8 text string
+     * @param text NUL-terminated string
+     * @return OCRE_SUCCESS, or OCRE_ERROR_NO_MEMORY if the buffer is full
+     */
+    int ocre_cbor_put_text(ocre_cbor_writer_t *writer, const char *text);
+
+    /**
+     * Encode a UTF-8 text string of known length
+     * @return OCRE_SUCCESS, or OCRE_ERROR_NO_MEMORY if the buffer is full
+     */
+    int ocre_cbor_put_text_len(ocre_cbor_writer_t *writer, const char *text, size_t len);
+
+    /**
+     * Encode a byte string
+     * @return OCRE_SUCCESS, or OCRE_ERROR_NO_MEMORY if the buffer is full
+     */
+    int ocre_cbor_put_bytes(ocre_cbor_writer_t *writer, const void *data, size_t len);
+
+    /**
+     * Start an array; the next @p count items are its elements
+     * @return OCRE_SUCCESS, or OCRE_ERROR_NO_MEMORY if the buffer is full
+     */
+    int ocre_cbor_put_array(ocre_cbor_writer_t *writer, size_t count);
+
+    /**
+     * Start a map; the next 2 * @p count items are its keys and values
+     * @return OCRE_SUCCESS, or OCRE_ERROR_NO_MEMORY if the buffer is full
+     */
+    int ocre_cbor_put_map(ocre_cbor_writer_t *writer, size_t count);
+
+    /**
+     * Encode a tag for the item that follows
+     * @return OCRE_SUCCESS, or OCRE_ERROR_NO_MEMORY if the buffer is full
+     */
+    int ocre_cbor_put_tag(ocre_cbor_writer_t *writer, uint64_t tag);
+
+    /**
+     * Publish the encoded buffer with content type OCRE_CONTENT_TYPE_CBOR
+     * @param topic Topic to publish on
+     * @param writer Encoder holding the payload
+     * @return OCRE_SUCCESS on success, the encoder's error or a publish error on failure
+     */
+    int ocre_cbor_publish(char *topic, const ocre_cbor_writer_t *writer);
+
+    /**
+     * Start decoding a buffer
+     */
+    void ocre_cbor_reader_init(ocre_cbor_reader_t *reader, const void *buf, size_t size);
+
+    /**
+     * Start decoding a message payload in place
+     * @return OCRE_SUCCESS, or OCRE_ERROR_INVALID if the content type is not
+     *         OCRE_CONTENT_TYPE_CBOR
+     */
+    int ocre_cbor_reader_init_msg(ocre_cbor_reader_t *reader, const ocre_msg_t *msg);
+
+    /**
+     * Decode the next item
+     *
+     * Arrays, maps and tags only yield their header; their contents follow as
+     * separate items. The reader is not advanced on failure, here and in the
+     * ocre_cbor_get_*() functions.
+     * @return OCRE_SUCCESS, OCRE_ERROR_NOT_FOUND at the end of the buffer, or
+     *         OCRE_ERROR_INVALID for malformed or unsupported input
+     */
+    int ocre_cbor_next(ocre_cbor_reader_t *reader, ocre_cbor_item_t *item);
+
+    /**
+     * Skip the next item, including the contents of arrays, maps and tags
+     * @return OCRE_SUCCESS, OCRE_ERROR_NOT_FOUND at the end of the buffer, or
+     *         OCRE_ERROR_INVALID for malformed input
+     */
+    int ocre_cbor_skip(ocre_cbor_reader_t *reader);
+
+    /**
+     * Decode the next item as a signed integer
+     * @return OCRE_SUCCESS, or OCRE_ERROR_INVALID if it is not an integer in range
+     */
+    int ocre_cbor_get_int(ocre_cbor_reader_t *reader, int64_t *value);
+
+    /**
+     * Decode the next item as a number; integers are converted
+     * @return OCRE_SUCCESS, or OCRE_ERROR_INVALID if it is not a number
+     */
+    int ocre_cbor_get_float(ocre_cbor_reader_t *reader, double *value);
+
+    /**
+     * Decode the next item as a text string, in place
+     * @param text Receives a pointer into the buffer (not NUL-terminated)
+     * @param len Receives the length in bytes
+     * @return OCRE_SUCCESS, or OCRE_ERROR_INVALID if it is not a text string
+     */
+    int ocre_cbor_get_text(ocre_cbor_reader_t *reader, const char **text, size_t *len);
+
+    /**
+     * Find a text key in the map that starts at the reader's position
+     * @param map Reader positioned at a map; not advanced
+     * @param key Key to look for
+     * @param value Receives a reader positioned at the key's value
+     * @return OCRE_SUCCESS, OCRE_ERROR_NOT_FOUND if the key is absent, or
+     *         OCRE_ERROR_INVALID if the item is not a map or is malformed
+     */
+    int ocre_cbor_map_find(const ocre_cbor_reader_t *map, const char *key, ocre_cbor_reader_t *value);
+
+    // =============================================================================
+    // Channel API
+    // =============================================================================
+    //
+    // Point-to-point message channels between two containers on the same node. The
+    // runtime maps one shared region into both containers and each end moves
+    // messages through it directly, without copying through the host. The runtime
+    // is only involved to wake an idle peer.
+
+    /**
+     * End of a channel opened by a container
+     */
+    typedef enum
+    {
+        OCRE_CHANNEL_PRODUCER,
+        OCRE_CHANNEL_CONSUMER,
+    } ocre_channel_role_t;
+
+    /**
+     * Shared channel ring
+     *
+     * Lock-free single-producer/single-consumer ring in a region the runtime maps
+     * into both containers. The runtime fills in the header when it creates the
+     * region; afterwards only the producer writes @c head and only the consumer
+     * writes @c tail. Both indices increase monotonically and are reduced modulo
+     * @c capacity, which must be a power of two. Each slot holds a 32-bit length
+     * followed by up to @c msg_size bytes. The indices sit on separate cache lines so
+     * the two ends do not contend.
+     *
+     * Wakeups are batched: a consumer that finds the ring empty sets
+     * @c consumer_waiting, and only the next send after that signals it, so one
+     * event covers every message written until the consumer drains the ring again.
+     * A producer that finds the ring full sets @c producer_waiting in the same way.
+     */
+    typedef struct
+    {
+        uint32_t version;          /**< Layout version, OCRE_CHANNEL_VERSION */
+        uint32_t capacity;         /**< Number of slots */
+        uint32_t msg_size;         /**< Largest message in bytes */
+        uint32_t slot_size;        /**< Bytes per slot, OCRE_CHANNEL_SLOT_SIZE(msg_size) */
+        uint32_t attached;         /**< Attached ends, bit per ocre_channel_role_t, written by the runtime */
+        uint32_t consumer_waiting; /**< Set by an idle consumer, cleared by the producer that wakes it */
+        uint32_t producer_waiting; /**< Set by a blocked producer, cleared by the consumer that wakes it */
+        uint8_t reserved[36];
+        uint32_t head;             /**< Producer index */
+        uint8_t head_pad[60];
+        uint32_t tail;             /**< Consumer index */
+        uint8_t tail_pad[60];
+        uint8_t slots[];           /**< @c capacity slots of @c slot_size bytes */
+    } ocre_channel_ring_t;
+
+#define OCRE_CHANNEL_SLOT_SIZE(msg_size) ((sizeof(uint32_t) + (msg_size) + 7u) & ~7u)
+#define OCRE_CHANNEL_RING_SIZE(capacity, msg_size) \
+    (sizeof(ocre_channel_ring_t) + (capacity) * OCRE_CHANNEL_SLOT_SIZE(msg_size))
+
+    /**
+     * An open end of a channel
+     */
+    typedef struct
+    {
+        ocre_channel_ring_t *ring; /**< Shared ring mapped by the runtime */
+        int32_t id;                /**< Channel ID; wakeups arrive as OCRE_RESOURCE_TYPE_CHANNEL events */
+        int32_t role;              /**< ocre_channel_role_t of this end */
+    } ocre_channel_t;
+
+    /**
+     * Attach to a named shared channel region, creating it on first attach
+     *
+     * Both ends must pass the same @p capacity and @p msg_size. Channel IDs are
+     * local to the container and below CONFIG_OCRE_CHANNEL_MAX.
+     * @param name Channel name shared by both containers
+     * @param role ocre_channel_role_t of the caller
+     * @param capacity Number of slots (power of two)
+     * @param msg_size Largest message in bytes
+     * @param ring Receives the address of the mapped ring
+     * @return Channel ID on success, OCRE_ERROR_BUSY if the role is already attached,
+     *         other negative error code on failure
+     */
+    int ocre_channel_attach(const char *name, int role, uint32_t capacity, uint32_t msg_size,
+                            ocre_channel_ring_t **ring);
+
+    /**
+     * Detach from a channel; the region is released when both ends have detached
+     * @param channel_id Channel ID from ocre_channel_attach()
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_channel_detach(int channel_id);
+
+    /**
+     * Queue an OCRE_RESOURCE_TYPE_CHANNEL event for the other end of a channel
+     * @param channel_id Channel ID of the caller's end
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_channel_signal(int channel_id);
+
+    /**
+     * Open one end of a channel
+     *
+     * Register a handler for OCRE_RESOURCE_TYPE_CHANNEL with @c channel->id to be
+     * woken when messages arrive (consumer) or space frees up after
+     * OCRE_ERROR_BUSY (producer). Channels are closed automatically when the
+     * container's messaging is cleaned up.
+     * @param channel Channel handle to initialize
+     * @param name Channel name, at most OCRE_MAX_CHANNEL_NAME_LEN - 1 characters
+     * @param role OCRE_CHANNEL_PRODUCER or OCRE_CHANNEL_CONSUMER
+     * @param capacity Number of slots (power of two)
+     * @param msg_size Largest message in bytes
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_channel_open(ocre_channel_t *channel, const char *name, ocre_channel_role_t role, uint32_t capacity,
+                          uint32_t msg_size);
+
+    /**
+     * Close an end of a channel
+     * @param channel Channel opened with ocre_channel_open()
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_channel_close(ocre_channel_t *channel);
+
+    /**
+     * Copy a message into the channel
+     * @param channel Producer end
+     * @param data Message bytes
+     * @param len Message length, at most the channel's msg_size
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_BUSY if the ring is full (the
+     *         producer is signaled once space frees up), OCRE_ERROR_INVALID on bad arguments
+     */
+    int ocre_channel_send(ocre_channel_t *channel, const void *data, uint32_t len);
+
+    /**
+     * Copy the oldest message out of the channel and consume it
+     * @param channel Consumer end
+     * @param buf Destination buffer
+     * @param size Size of @p buf
+     * @return Message length on success, OCRE_ERROR_NOT_FOUND if the ring is empty
+     *         (the consumer is signaled by the next send), OCRE_ERROR_INVALID if
+     *         @p buf is too small; the message is then left in the ring
+     */
+    int ocre_channel_recv(ocre_channel_t *channel, void *buf, uint32_t size);
+
+    /**
+     * Access the oldest message in place without consuming it
+     * @param channel Consumer end
+     * @param data Receives a pointer into the shared ring, valid until ocre_channel_consume()
+     * @param len Receives the message length
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_NOT_FOUND if the ring is empty
+     */
+    int ocre_channel_peek(ocre_channel_t *channel, const void **data, uint32_t *len);
+
+    /**
+     * Consume the message returned by ocre_channel_peek()
+     * @param channel Consumer end
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_NOT_FOUND if the ring is empty
+     */
+    int ocre_channel_consume(ocre_channel_t *channel);
+
+    /**
+     * Get the number of messages in the channel
+     * @param channel Either end
+     * @return Number of unread messages
+     */
+    int ocre_channel_available(const ocre_channel_t *channel);
+
+    // =============================================================================
+    // Event API
+    // =============================================================================
+
+    /**
+     * Timer callback function type
+     */
+    typedef void (*timer_callback_func_t)(void);
+
+    /**
+     * GPIO callback function type
+     */
+    typedef void (*gpio_callback_func_t)(void);
+
+    /**
+     * Sensor callback function type
+     */
+    typedef void (*sensor_callback_func_t)(void);
+
+    /**
+     * Get event data for a specific resource
+     * Offsets are linear-memory addresses (32-bit in WASM, native pointers in the
+     * native host emulation). No timestamp is returned, so events retrieved this
+     * way have event_data_t.timestamp_ns set to 0 (unknown).
+     * @param type_offset Offset for resource type
+     * @param id_offset Offset for resource ID
+     * @param port_offset Offset for port number
+     * @param state_offset Offset for state
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_get_event(uintptr_t type_offset, uintptr_t id_offset, uintptr_t port_offset,
+                       uintptr_t state_offset);
+
+    /**
+     * Shared-memory event ring
+     *
+     * Single-producer/single-consumer ring of events placed in guest linear memory.
+     * The host is the only writer of @c head, @c overflow and the event slots; the
+     * guest is the only writer of @c tail. Both indices increase monotonically and
+     * are reduced modulo @c capacity, which must be a power of two.
+     *
+     * When the ring is full the host queues further events internally and sets
+     * @c overflow. While @c overflow is set the host keeps queuing (so ordering is
+     * preserved) and the guest drains the ring first, then ocre_get_event(). The host
+     * clears @c overflow when ocre_get_event() hands out its last queued event.
+     */
+    typedef struct
+    {
+        uint32_t version;  /**< Layout version, OCRE_EVENT_RING_VERSION */
+        uint32_t capacity; /**< Number of slots in @c events */
+        uint32_t head;     /**< Producer index, written by the host */
+        uint32_t tail;     /**< Consumer index, written by the guest */
+        uint32_t overflow; /**< Non-zero while the host holds events in its own queue */
+        uint32_t reserved; /**< Keeps @c events 8-byte aligned */
+        event_data_t events[CONFIG_OCRE_EVENT_RING_SIZE]; /**< Event slots */
+    } ocre_event_ring_t;
+
+    /**
+     * Register a shared-memory event ring with the runtime
+     * @param ring Ring located in guest linear memory
+     * @param capacity Number of event slots in the ring (power of two)
+     * @return OCRE_SUCCESS on success, negative error code if unsupported or invalid
+     */
+    int ocre_register_event_ring(ocre_event_ring_t *ring, uint32_t capacity);
+
+    /**
+     * Switch event delivery to the SDK's shared-memory event ring
+     *
+     * Once enabled, ocre_process_events() drains events directly from linear memory
+     * without calling into the runtime. If the runtime does not support event rings
+     * the SDK keeps using ocre_get_event().
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_event_ring_enable(void);
+
+    /**
+     * Block until an event is pending or the timeout expires
+     *
+     * Returns immediately if an event is already queued or present in a registered
+     * event ring.
+     * @param timeout_ms Maximum time to wait in milliseconds
+     * @return OCRE_SUCCESS if an event is pending, OCRE_ERROR_TIMEOUT if the timeout
+     *         expired, other negative error code if waiting is not supported
+     */
+    int ocre_wait_events(int timeout_ms);
+
+    /**
+     * Process the events from runtime
+     *
+     * Dispatches up to CONFIG_OCRE_EVENTS_PER_LOOP events. When no event is pending,
+     * waits up to CONFIG_OCRE_EVENT_WAIT_TIMEOUT_MS for the next one, or sleeps
+     * CONFIG_OCRE_EVENT_IDLE_SLEEP_MS on runtimes without ocre_wait_events().
+     */
+    void ocre_process_events(void);
+
+    /**
+     * Outcome of one ocre_process_events_ex() call
+     */
+    typedef struct
+    {
+        uint32_t processed; /**< Events dispatched to callbacks */
+        uint32_t coalesced; /**< Events absorbed by debouncing or coalescing */
+        int32_t remaining;  /**< Events still pending, or -1 if the runtime cannot tell */
+    } ocre_event_loop_result_t;
+
+    /**
+     * Process pending events within an event budget and a time budget
+     *
+     * Dispatches events until the queue is empty, @p max_events events have been
+     * dispatched or @p max_us microseconds have elapsed, whichever comes first.
+     * Malformed events are dropped but count against @p max_events. The time budget
+     * is checked between events, so one slow callback can overrun it.
+     * Unlike ocre_process_events() this never blocks waiting for events.
+     *
+     * @c remaining is exact while events come from the shared event ring and is -1
+     * when the runtime holds events the SDK cannot count.
+     * @param max_events Most events to dispatch, 0 or negative for no limit
+     * @param max_us Time budget in microseconds, 0 for no limit
+     * @param result Filled with the outcome of the call, may be NULL
+     * @return Number of events dispatched
+     */
+    int ocre_process_events_ex(int max_events, uint32_t max_us, ocre_event_loop_result_t *result);
+
+    // Histogram buckets: bucket 0 counts values under 1 us, bucket i counts
+    // [2^(i-1), 2^i) us and the last bucket also counts everything larger
+#define OCRE_SDK_STATS_BUCKETS 16
+
+    /**
+     * Event loop and dispatch statistics
+     *
+     * Collected only when the SDK is built with CONFIG_OCRE_SDK_STATS; otherwise the
+     * counters compile out. Counters wrap at 2^32.
+     */
+    typedef struct
+    {
+        uint32_t retrieved[OCRE_RESOURCE_TYPE_COUNT];  /**< Valid events taken from the runtime */
+        uint32_t dispatched[OCRE_RESOURCE_TYPE_COUNT]; /**< Events that reached a dispatcher */
+        uint32_t unhandled[OCRE_RESOURCE_TYPE_COUNT];  /**< Events with no callback or waiting task */
+        uint32_t invalid;          /**< Malformed events dropped */
+        uint32_t coalesced;        /**< Events absorbed by debouncing or coalescing */
+        uint32_t loops;            /**< ocre_process_events_ex() calls */
+        uint32_t idle_waits;       /**< Waits or sleeps because no event was pending */
+        uint32_t loop_high_water;  /**< Most events one call took from the queue */
+        uint32_t callback_us[OCRE_SDK_STATS_BUCKETS]; /**< Dispatch time histogram */
+        uint32_t event_age_us[OCRE_SDK_STATS_BUCKETS]; /**< Time from event to dispatch, for timestamped events */
+    } ocre_sdk_stats_t;
+
+    /**
+     * Copy the current statistics
+     * @param stats Destination
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_NOT_FOUND if statistics are compiled out
+     */
+    int ocre_sdk_stats_get(ocre_sdk_stats_t *stats);
+
+    /**
+     * Clear all statistics
+     */
+    void ocre_sdk_stats_reset(void);
+
+    /**
+     * Write the statistics to the SDK log as untagged records, regardless of the log level
+     * Read them with ocre_log_read() or ocre_log_dump(). Also exported as
+     * "ocre_sdk_stats_dump" so the runtime can trigger it on demand.
+     */
+    void ocre_sdk_stats_dump(void);
+
+    /**
+     * Unregister GPIO callback
+     * @param pin GPIO pin number
+     * @param port GPIO port number
+     * @return 0 on success, negative error code on failure
+     */
+    int ocre_unregister_gpio_callback(int pin, int port);
+
+    /**
+     * Unregister timer callback
+     * @param timer_id Timer identifier
+     * @return 0 on success, negative error code on failure
+     */
+    int ocre_unregister_timer_callback(int timer_id);
+
+    /**
+     * Register GPIO callback
+     * @param pin GPIO pin number
+     * @param port GPIO port number
+     * @param callback Callback function to register
+     * @return 0 on success, negative error code on failure
+     */
+    int ocre_register_gpio_callback(int pin, int port, gpio_callback_func_t callback);
+
+    /**
+     * Register timer callback
+     * @param timer_id Timer identifier
+     * @param callback Callback function to register
+     * @return 0 on success, negative error code on failure
+     */
+    int ocre_register_timer_callback(int timer_id, timer_callback_func_t callback);
+
+    /**
+     * Register sensor callback, called for each sensor event (e.g. stream notifications)
+     * @param sensor_id Sensor identifier
+     * @param callback Callback function to register
+     * @return 0 on success, negative error code on failure
+     */
+    int ocre_register_sensor_callback(int sensor_id, sensor_callback_func_t callback);
+
+    /**
+     * Unregister sensor callback
+     * @param sensor_id Sensor identifier
+     * @return 0 on success, negative error code on failure
+     */
+    int ocre_unregister_sensor_callback(int sensor_id);
+
+    /**
+     * Event handler with the full event and a user context
+     * @param event Event being dispatched; valid only during the call
+     * @param user_ctx Context pointer given at registration
+     */
+    typedef void (*ocre_event_handler_t)(const event_data_t *event, void *user_ctx);
+
+    /**
+     * Register a handler for one resource in the SDK dispatch table
+     *
+     * Timers, GPIO pins, sensors, channels and GPIO captures share one table
+     * indexed by type and ID, so the same handler can serve many resources with a
+     * different @p user_ctx each. A registration replaces any handler or legacy
+     * callback for the resource. The type's dispatcher is registered with the
+     * runtime on first use only.
+     * @param type Any resource type, e.g. OCRE_RESOURCE_TYPE_GPIO
+     * @param id Timer ID, GPIO pin, sensor ID, channel ID or capture ID
+     * @param port GPIO port; ignored for other types
+     * @param handler Handler to call for the resource's events
+     * @param user_ctx Context pointer passed to @p handler
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_INVALID if the resource is out of
+     *         range, other negative error code if the dispatcher cannot be registered
+     */
+    int ocre_register_event_handler(ocre_resource_type_t type, int id, int port, ocre_event_handler_t handler,
+                                    void *user_ctx);
+
+    /**
+     * Remove the handler or legacy callback of a resource
+     * @param type Resource type
+     * @param id Timer ID, GPIO pin, sensor ID, channel ID or capture ID
+     * @param port GPIO port; ignored for other types
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_NOT_FOUND if nothing was registered,
+     *         OCRE_ERROR_INVALID if the resource is out of range
+     */
+    int ocre_unregister_event_handler(ocre_resource_type_t type, int id, int port);
+
+    /**
+     * Register the SDK dispatcher for a resource type with the runtime, once
+     *
+     * Called by the registration functions and the task scheduler; later calls for
+     * the same type return without crossing into the runtime.
+     * @param type Resource type
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_dispatcher_enable(ocre_resource_type_t type);
+
+    /**
+     * Debounce a GPIO input
+     *
+     * Each GPIO event for the pin restarts a settle window. The callback runs once
+     * the input has been stable for @p debounce_ms, and only if the settled level
+     * differs from the last level delivered. Windows run on soft timers; if more
+     * than CONFIG_OCRE_GPIO_DEBOUNCE_SLOTS pins are settling at once, further
+     * events are delivered undebounced.
+     * @param pin GPIO pin number
+     * @param port GPIO port number
+     * @param debounce_ms Settle time in milliseconds, 0 to disable
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_gpio_set_debounce(int pin, int port, uint32_t debounce_ms);
+
+    /**
+     * Deliver only the latest state of a GPIO pin
+     *
+     * Events for the pin retrieved by one ocre_process_events() call are merged and
+     * the callback runs once, after the other events of that call, if the final
+     * level differs from the last level delivered. Merged events do not count
+     * toward the per-call event budget.
+     * @param pin GPIO pin number
+     * @param port GPIO port number
+     * @param latest_only true to coalesce events, false to deliver every event
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_gpio_set_coalesce(int pin, int port, bool latest_only);
+
+    /**
+     * Coalesce overrun expiries of a timer
+     *
+     * When a periodic timer expires several times before the container catches up,
+     * the expiries retrieved by one ocre_process_events() call run the callback
+     * once. Missed periods are dropped rather than replayed back to back.
+     * @param timer_id Timer identifier
+     * @param coalesce true to coalesce expiries, false to deliver every expiry
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_timer_set_coalesce(int timer_id, bool coalesce);
+
+    // =============================================================================
+    // Task API
+    // =============================================================================
+    //
+    // Cooperative stackless tasks (protothreads) scheduled by ocre_process_events().
+    // A task function resumes where it last awaited, so sequential logic can wait
+    // on timers, GPIO edges, sensor events and messages without blocking the
+    // container. Local variables do not survive an await; keep state in the
+    // task's user context. switch statements cannot span an await.
+    //
+    //     static int blink(ocre_task_t *task)
+    //     {
+    //         OCRE_TASK_BEGIN(task);
+    //         while (true)
+    //         {
+    //             OCRE_TASK_AWAIT_GPIO(task, BUTTON_PIN, BUTTON_PORT, 0);
+    //             ocre_gpio_pin_toggle(LED_PORT, LED_PIN);
+    //             OCRE_TASK_SLEEP(task, 500);
+    //         }
+    //         OCRE_TASK_END(task);
+    //     }
+
+    // Task function results
+#define OCRE_TASK_WAITING 0 // Suspended until the awaited event
+#define OCRE_TASK_YIELDED 1 // Ready to run again on the next scheduler pass
+#define OCRE_TASK_EXITED 2  // Finished; the scheduler forgets the task
+
+// Wait kinds for ocre_task_wait() besides the resource types
+#define OCRE_TASK_WAIT_SLEEP -1
+#define OCRE_TASK_WAIT_MESSAGE OCRE_RESOURCE_TYPE_COUNT
+
+    typedef struct ocre_task ocre_task_t;
+
+    /**
+     * Task function type
+     * @param task Running task
+     * @return OCRE_TASK_WAITING, OCRE_TASK_YIELDED or OCRE_TASK_EXITED (returned by
+     *         the OCRE_TASK_* macros)
+     */
+    typedef int (*ocre_task_func_t)(ocre_task_t *task);
+
+    struct ocre_task
+    {
+        ocre_task_func_t func;  /**< Task function */
+        void *user_ctx;         /**< Context for the task function */
+        ocre_task_t *next;      /**< Next task known to the scheduler */
+        uint32_t resume;        /**< Resume point, 0 at the start */
+        uint8_t status;         /**< Scheduler state */
+        bool timed_out;         /**< The last await ended by timeout */
+        int8_t wait_type;       /**< Awaited event kind */
+        int32_t wait_id;        /**< Awaited resource ID */
+        int32_t wait_port;      /**< Awaited port, -1 for any */
+        int32_t event_state;    /**< State of the event that woke the task */
+        int route_id;           /**< Message route from ocre_task_subscribe(), -1 if none */
+        const ocre_msg_t *msg;  /**< Message being delivered, valid until the next await */
+        ocre_soft_timer_t timer; /**< Sleep and timeout timer */
+    };
+
+    /**
+     * Start a task; it first runs on the next scheduler pass
+     * @param task Task storage, owned by the caller and valid until the task exits
+     * @param func Task function
+     * @param user_ctx Context available as task->user_ctx
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_task_start(ocre_task_t *task, ocre_task_func_t func, void *user_ctx);
+
+    /**
+     * Stop a task and release its timer and message route
+     *
+     * Must not be called from a message handler or from a task resumed by a message.
+     * @param task Task to stop
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_NOT_FOUND if the task is not running
+     */
+    int ocre_task_stop(ocre_task_t *task);
+
+    /**
+     * Route messages matching an MQTT-style topic filter to a task
+     *
+     * Call once before the first OCRE_TASK_AWAIT_MESSAGE(); the route is removed when
+     * the task exits or is stopped. Messages arriving while the task is not awaiting
+     * one are dropped; the router still releases them.
+     * @param task Started task
+     * @param filter Topic filter, see ocre_msg_route_add()
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_task_subscribe(ocre_task_t *task, const char *filter);
+
+    /**
+     * Run every ready task once
+     *
+     * Called by ocre_process_events(); applications with their own loop may call it
+     * directly.
+     * @return Number of tasks run
+     */
+    int ocre_task_run(void);
+
+    /**
+     * Check whether any task is ready to run
+     * @return true if ocre_task_run() has work to do
+     */
+    bool ocre_task_ready(void);
+
+    /**
+     * Wake tasks awaiting an event; called by the SDK event dispatchers
+     * @return Number of tasks woken
+     */
+    int ocre_task_notify(ocre_resource_type_t type, int id, int port, int state);
+
+    /**
+     * Suspend a task until an event or a timeout; used by the OCRE_TASK_AWAIT_* macros
+     * @param task Running task
+     * @param type Resource type, OCRE_TASK_WAIT_MESSAGE or OCRE_TASK_WAIT_SLEEP
+     * @param id Resource ID (timer, GPIO pin or sensor), ignored for messages
+     * @param port GPIO port, -1 for any
+     * @param timeout_ms Timeout in milliseconds, 0 for none
+     */
+    void ocre_task_wait(ocre_task_t *task, int type, int id, int port, uint32_t timeout_ms);
+
+#define OCRE_TASK_BEGIN(task)                                                                          \
+    switch ((task)->resume)                                                                            \
+    {                                                                                                  \
+    case 0:
+
+#define OCRE_TASK_END(task)                                                                            \
+    }                                                                                                  \
+    (task)->resume = 0;                                                                                \
+    return OCRE_TASK_EXITED
+
+#define OCRE_TASK_SUSPEND_(task, result)                                                               \
+    do                                                                                                 \
+    {                                                                                                  \
+        (task)->resume = __LINE__;                                                                     \
+        return (result);                                                                               \
+    case __LINE__:;                                                                                    \
+    } while (0)
+
+// Give other tasks a turn; the task runs again on the next scheduler pass
+#define OCRE_TASK_YIELD(task) OCRE_TASK_SUSPEND_(task, OCRE_TASK_YIELDED)
+
+// Finish the task from anywhere in its body
+#define OCRE_TASK_EXIT(task)                                                                           \
+    do                                                                                                 \
+    {                                                                                                  \
+        (task)->resume = 0;                                                                            \
+        return OCRE_TASK_EXITED;                                                                       \
+    } while (0)
+
+// Re-check a condition on every scheduler pass until it holds
+#define OCRE_TASK_AWAIT_UNTIL(task, condition)                                                         \
+    do                                                                                                 \
+    {                                                                                                  \
+        (task)->resume = __LINE__;                                                                     \
+    case __LINE__:                                                                                     \
+        if (!(condition))                                                                              \
+        {                                                                                              \
+            return OCRE_TASK_YIELDED;                                                                  \
+        }                                                                                              \
+    } while (0)
+
+#define OCRE_TASK_AWAIT_EVENT_(task, type, id, port, timeout_ms)                                       \
+    do                                                                                                 \
+    {                                                                                                  \
+        ocre_task_wait((task), (type), (id), (port), (timeout_ms));                                    \
+        OCRE_TASK_SUSPEND_(task, OCRE_TASK_WAITING);                                                   \
+    } while (0)
+
+// Sleep on a soft timer
+#define OCRE_TASK_SLEEP(task, ms) OCRE_TASK_AWAIT_EVENT_(task, OCRE_TASK_WAIT_SLEEP, 0, -1, (ms))
+
+// Await an expiry of runtime timer @p timer_id; timeout_ms 0 waits forever
+#define OCRE_TASK_AWAIT_TIMER(task, timer_id, timeout_ms)                                              \
+    OCRE_TASK_AWAIT_EVENT_(task, OCRE_RESOURCE_TYPE_TIMER, (timer_id), 0, (timeout_ms))
+
+// Await a GPIO event on a pin; the new level is in task->event_state
+#define OCRE_TASK_AWAIT_GPIO(task, pin, port, timeout_ms)                                              \
+    OCRE_TASK_AWAIT_EVENT_(task, OCRE_RESOURCE_TYPE_GPIO, (pin), (port), (timeout_ms))
+
+// Await a sensor event, such as a stream notification
+#define OCRE_TASK_AWAIT_SENSOR(task, sensor_id, timeout_ms)                                            \
+    OCRE_TASK_AWAIT_EVENT_(task, OCRE_RESOURCE_TYPE_SENSOR, (sensor_id), -1, (timeout_ms))
+
+// Await a batch of captured GPIO edges; the number of unread edges is in task->event_state
+#define OCRE_TASK_AWAIT_GPIO_CAPTURE(task, capture_id, timeout_ms)                                     \
+    OCRE_TASK_AWAIT_EVENT_(task, OCRE_RESOURCE_TYPE_GPIO_CAPTURE, (capture_id), -1, (timeout_ms))
+
+// Await a message on the task's subscription; the message is in task->msg
+#define OCRE_TASK_AWAIT_MESSAGE(task, timeout_ms)                                                      \
+    OCRE_TASK_AWAIT_EVENT_(task, OCRE_TASK_WAIT_MESSAGE, 0, -1, (timeout_ms))
+
+    // =============================================================================
+    // Clock API
+    // =============================================================================
+
+    /**
+     * Shared time page
+     *
+     * Placed in guest linear memory and kept up to date by the runtime, so the guest
+     * reads the time without crossing into the runtime, much like a vDSO data page.
+     * The runtime refreshes @c monotonic_ns at least every @c resolution_ns and
+     * whenever it queues an event. Each update increments @c seq before and after
+     * writing, so @c seq is odd while an update is in progress.
+     */
+    typedef struct
+    {
+        uint32_t version;       /**< Layout version, OCRE_TIME_PAGE_VERSION */
+        uint32_t seq;           /**< Update sequence, written by the runtime */
+        uint64_t monotonic_ns;  /**< Runtime monotonic time at the last update */
+        uint32_t resolution_ns; /**< Longest interval between updates */
+        uint32_t reserved;
+    } ocre_time_page_t;
+
+    /**
+     * Register a time page with the runtime
+     * @param page Time page located in guest linear memory
+     * @return OCRE_SUCCESS on success, negative error code if unsupported or invalid
+     */
+    int ocre_time_page_register(ocre_time_page_t *page);
+
+    /**
+     * Get the monotonic time
+     *
+     * Reads the shared time page when the runtime supports one, which costs a few
+     * loads; otherwise falls back to clock_gettime(). The time base is the same as
+     * event_data_t.timestamp_ns.
+     * @return Monotonic time in nanoseconds
+     */
+    uint64_t ocre_clock_monotonic_ns(void);
+
+    /**
+     * Get the monotonic time in milliseconds
+     * @return Monotonic time in milliseconds
+     */
+    uint64_t ocre_clock_monotonic_ms(void);
+
+    /**
+     * Check whether the clock is served from the shared time page
+     * @return true if reading the clock does not cross into the runtime
+     */
+    bool ocre_clock_is_shared(void);
+
+    // =============================================================================
+    // Utility API
+    // =============================================================================
+
+    /**
+     * Sleep for specified duration
+     * @param milliseconds Sleep duration in milliseconds
+     * @return OCRE_SUCCESS on success, error code on failure
+     */
+    int ocre_sleep(int milliseconds);
+
+/**
+ * Pause execution indefinitely (implementation-specific)
+ * @return OCRE_SUCCESS on success, error code on failure
+ */
+#define ocre_pause() ocre_sleep(9999999)
+
+    // =============================================================================
+    // Logging API
+    // =============================================================================
+
+    /**
+     * In-memory log ring
+     *
+     * Log lines are appended at @c head; when the ring is full the oldest bytes are
+     * overwritten and @c tail moves forward. Both indices increase monotonically and
+     * are reduced modulo @c size. A host tool can read the ring directly from linear
+     * memory (see ocre_log_get_buffer()) or call the exported "ocre_log_dump".
+     */
+    typedef struct
+    {
+        uint32_t size;    /**< Size of @c data in bytes */
+        uint32_t head;    /**< Write index */
+        uint32_t tail;    /**< Oldest unread byte */
+        uint32_t dropped; /**< Bytes overwritten before they were read */
+        char data[CONFIG_OCRE_LOG_BUFFER_SIZE]; /**< Log text, one line per record */
+    } ocre_log_buffer_t;
+
+    /**
+     * Append a formatted record to the log ring
+     * @param level Log level (OCRE_LOG_LEVEL_*)
+     * @param fmt printf-style format string
+     */
+    void ocre_log_write(int level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    /**
+     * Copy and consume unread log text
+     * @param buf Destination buffer
+     * @param len Size of the destination buffer
+     * @return Number of bytes copied
+     */
+    size_t ocre_log_read(char *buf, size_t len);
+
+    /**
+     * Write all unread log text to stdout and consume it
+     * Also exported as "ocre_log_dump" so the runtime can trigger it on demand.
+     */
+    void ocre_log_dump(void);
+
+    /**
+     * Get the log ring for direct inspection
+     * @return Pointer to the log ring in linear memory
+     */
+    ocre_log_buffer_t *ocre_log_get_buffer(void);
+
+/**
+ * Log at a level known at compile time; levels above CONFIG_OCRE_LOG_LEVEL compile to nothing
+ */
+#define OCRE_LOG(level, ...)                          \
+    do                                                \
+    {                                                 \
+        if ((level) <= CONFIG_OCRE_LOG_LEVEL)         \
+        {                                             \
+            ocre_log_write((level), __VA_ARGS__);     \
+        }                                             \
+    } while (0)
+
+#if CONFIG_OCRE_LOG_LEVEL >= OCRE_LOG_LEVEL_ERR
+#define OCRE_LOG_ERR(...) ocre_log_write(OCRE_LOG_LEVEL_ERR, __VA_ARGS__)
+#else
+#define OCRE_LOG_ERR(...) ((void)0)
+#endif
+
+#if CONFIG_OCRE_LOG_LEVEL >= OCRE_LOG_LEVEL_WRN
+#define OCRE_LOG_WRN(...) ocre_log_write(OCRE_LOG_LEVEL_WRN, __VA_ARGS__)
+#else
+#define OCRE_LOG_WRN(...) ((void)0)
+#endif
+
+#if CONFIG_OCRE_LOG_LEVEL >= OCRE_LOG_LEVEL_INF
+#define OCRE_LOG_INF(...) ocre_log_write(OCRE_LOG_LEVEL_INF, __VA_ARGS__)
+#else
+#define OCRE_LOG_INF(...) ((void)0)
+#endif
+
+#if CONFIG_OCRE_LOG_LEVEL >= OCRE_LOG_LEVEL_DBG
+#define OCRE_LOG_DBG(...) ocre_log_write(OCRE_LOG_LEVEL_DBG, __VA_ARGS__)
+#else
+#define OCRE_LOG_DBG(...) ((void)0)
+#endif
+
+    // =============================================================================
+    // Sensor API
+    // =============================================================================
+
+    /**
+     * Sensor handle type
+     */
+    typedef int ocre_sensor_handle_t;
+
+    /**
+     * Initialize the sensor system
+     * @return 0 on success
+     */
+    int ocre_sensors_init(void);
+
+    /**
+     * Discover available sensors
+     * Also invalidates the SDK's cache of sensors resolved by name.
+     * @return Number of discovered sensors, negative error code on failure
+     */
+    int ocre_sensors_discover(void);
+
+    /**
+     * Open a sensor for use
+     * @param handle Handle of the sensor to open
+     * @return 0 on success, negative error code on failure
+     */
+    int ocre_sensors_open(ocre_sensor_handle_t handle);
+
+    /**
+     * Get the handle of a sensor
+     * @param sensor_id ID of the sensor
+     * @return Sensor handle on success, negative error code on failure
+     */
+    int ocre_sensors_get_handle(int sensor_id);
+
+    /**
+     * Get the number of channels available in a sensor
+     * @param sensor_id ID of the sensor
+     * @return Number of channels on success, negative error code on failure
+     */
+    int ocre_sensors_get_channel_count(int sensor_id);
+
+    /**
+     * Get the type of a specific sensor channel
+     * @param sensor_id ID of the sensor
+     * @param channel_index Index of the channel
+     * @return Channel type on success, negative error code on failure
+     */
+    int ocre_sensors_get_channel_type(int sensor_id, int channel_index);
+
+    /**
+     * Read data from a sensor channel
+     * @param sensor_id ID of the sensor
+     * @param channel_type Type of the channel to read
+     * @return Sensor value in integer format, negative error code on failure
+     */
+    int ocre_sensors_read(int sensor_id, int channel_type);
+
+    /*
+     * The *_by_name functions below are implemented by the SDK. A name is resolved
+     * with the runtime once and kept in a cache of CONFIG_OCRE_SENSOR_CACHE_SIZE
+     * entries together with its handle, sensor ID and channel metadata. The sensor
+     * ID is found by matching ocre_sensors_get_handle() over the discovered IDs.
+     * Later calls turn into runtime calls by handle or ID, without name lookups.
+     * The cache is invalidated by ocre_sensors_discover().
+     */
+
+    /**
+     * Get the handle of a sensor by name
+     * @param sensor_name Name of the sensor
+     * @return Sensor handle on success, negative error code on failure
+     */
+    int ocre_sensors_get_handle_by_name(const char *sensor_name);
+
+    /**
+     * Open a sensor by name
      * @param sensor_name Name of the sensor
      * @return OCRE_SUCCESS on success, negative error code on failure
      */
@@ -435,6 +2233,254 @@ extern "C"
      */
     int ocre_sensors_read_by_name(const char *sensor_name, int channel_type);
 
+    /**
+     * Sensor value in micro-units of the channel's unit (value / OCRE_SENSOR_VALUE_SCALE)
+     */
+    typedef int64_t ocre_sensor_value_t;
+
+#define OCRE_SENSOR_VALUE_SCALE 1000000
+
+    /**
+     * Read several channels of a sensor from a single sample
+     * @param sensor_id ID of the sensor
+     * @param channel_types Types of the channels to read
+     * @param values Receives one value per entry of @c channel_types
+     * @param count Number of channels to read
+     * @param timestamp_ns Receives the time the sample was taken, in nanoseconds; may be NULL
+     * @return Number of channels read on success, negative error code on failure
+     */
+    int ocre_sensors_read_multi(int sensor_id, const int *channel_types, ocre_sensor_value_t *values, int count,
+                                uint64_t *timestamp_ns);
+
+    /**
+     * Read several channels of a sensor referenced by name from a single sample
+     * @param sensor_name Name of the sensor
+     * @param channel_types Types of the channels to read
+     * @param values Receives one value per entry of @c channel_types
+     * @param count Number of channels to read
+     * @param timestamp_ns Receives the time the sample was taken, in nanoseconds; may be NULL
+     * @return Number of channels read on success, negative error code on failure
+     */
+    int ocre_sensors_read_multi_by_name(const char *sensor_name, const int *channel_types,
+                                        ocre_sensor_value_t *values, int count, uint64_t *timestamp_ns);
+
+    /**
+     * One timestamped sample of a sensor stream
+     */
+    typedef struct
+    {
+        uint64_t timestamp_ns; /**< Time the sample was taken, in nanoseconds */
+        ocre_sensor_value_t values[CONFIG_OCRE_SENSOR_STREAM_MAX_CHANNELS]; /**< One value per streamed channel */
+    } ocre_sensor_sample_t;
+
+    /**
+     * Sensor stream sample ring
+     *
+     * Single-producer/single-consumer ring in guest linear memory. The host samples
+     * the sensor at the configured rate, writes samples and advances @c head; the
+     * guest is the only writer of @c tail. Both indices increase monotonically and
+     * are reduced modulo @c capacity. When the ring is full the host drops the new
+     * sample and increments @c dropped.
+     */
+    typedef struct
+    {
+        uint32_t version;       /**< Layout version, OCRE_SENSOR_STREAM_VERSION */
+        uint32_t capacity;      /**< Number of slots in @c samples */
+        uint32_t channel_count; /**< Number of valid entries in each sample's values */
+        uint32_t head;          /**< Producer index, written by the host */
+        uint32_t tail;          /**< Consumer index, written by the guest */
+        uint32_t dropped;       /**< Samples lost because the ring was full */
+        int32_t sensor_id;      /**< Streamed sensor (guest bookkeeping) */
+        ocre_sensor_sample_t samples[CONFIG_OCRE_SENSOR_STREAM_DEPTH]; /**< Sample slots */
+    } ocre_sensor_stream_t;
+
+    /**
+     * Start host-driven sampling of a sensor into a guest ring
+     *
+     * After every @c notify_every samples the runtime queues an
+     * OCRE_RESOURCE_TYPE_SENSOR event with id set to @c sensor_id.
+     * @param sensor_id ID of the sensor
+     * @param channel_types Types of the channels to sample
+     * @param channel_count Number of channels
+     * @param rate_hz Sampling rate in samples per second
+     * @param notify_every Number of samples between notifications
+     * @param stream Sample ring located in guest linear memory
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_sensors_stream_start(int sensor_id, const int *channel_types, int channel_count, int rate_hz,
+                                  int notify_every, ocre_sensor_stream_t *stream);
+
+    /**
+     * Stop host-driven sampling of a sensor
+     * @param sensor_id ID of the sensor
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_sensors_stream_stop(int sensor_id);
+
+    /**
+     * Initialize a stream ring and start streaming a sensor into it
+     *
+     * Register a callback with ocre_register_sensor_callback() to be notified
+     * when samples are available.
+     * @param stream Stream ring to initialize; must stay valid until closed
+     * @param sensor_id ID of the sensor
+     * @param channel_types Types of the channels to sample
+     * @param channel_count Number of channels, at most CONFIG_OCRE_SENSOR_STREAM_MAX_CHANNELS
+     * @param rate_hz Sampling rate in samples per second
+     * @param notify_every Number of samples between notifications, at most CONFIG_OCRE_SENSOR_STREAM_DEPTH
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_sensor_stream_open(ocre_sensor_stream_t *stream, int sensor_id, const int *channel_types,
+                                int channel_count, int rate_hz, int notify_every);
+
+    /**
+     * Stop streaming; unread samples remain readable
+     * @param stream Stream ring passed to ocre_sensor_stream_open()
+     * @return OCRE_SUCCESS on success, negative error code on failure
+     */
+    int ocre_sensor_stream_close(ocre_sensor_stream_t *stream);
+
+    /**
+     * Get the number of unread samples
+     * @param stream Stream ring
+     * @return Number of samples available
+     */
+    int ocre_sensor_stream_available(const ocre_sensor_stream_t *stream);
+
+    /**
+     * Copy and consume samples from a stream
+     * @param stream Stream ring
+     * @param samples Destination array
+     * @param max_samples Capacity of @c samples
+     * @return Number of samples copied, negative error code on failure
+     */
+    int ocre_sensor_stream_read(ocre_sensor_stream_t *stream, ocre_sensor_sample_t *samples, int max_samples);
+
+    /**
+     * Window of a sensor aggregation stage
+     */
+    typedef enum
+    {
+        OCRE_SENSOR_AGG_TUMBLING, /**< Consecutive windows that do not overlap */
+        OCRE_SENSOR_AGG_SLIDING   /**< The latest @c window samples, evaluated every @c step samples */
+    } ocre_sensor_agg_window_t;
+
+// Statistics published by an aggregation stage
+#define OCRE_SENSOR_AGG_MIN 0x1
+#define OCRE_SENSOR_AGG_MAX 0x2
+#define OCRE_SENSOR_AGG_MEAN 0x4
+#define OCRE_SENSOR_AGG_RMS 0x8
+#define OCRE_SENSOR_AGG_ALL 0xF
+
+    /**
+     * Configuration of a sensor aggregation stage
+     *
+     * Raw samples are first decimated, then collected into windows. A result is
+     * emitted when a window closes. With a deadband, both checks compare samples
+     * against the newest sample of the last emitted result: a closing window is
+     * only emitted if its newest sample moved by more than @c deadband, and a
+     * sample that moves by more than @c deadband emits the current window at once
+     * and restarts the count towards the next result.
+     */
+    typedef struct
+    {
+        uint32_t window_type;         /**< ocre_sensor_agg_window_t */
+        uint32_t window;              /**< Samples per window; at most CONFIG_OCRE_SENSOR_AGG_WINDOW_MAX if sliding */
+        uint32_t step;                /**< Samples between results of a sliding window, 1 to @c window */
+        uint32_t decimation;          /**< Keep one raw sample in this many; 0 or 1 keeps all */
+        uint32_t stats;               /**< OCRE_SENSOR_AGG_* statistics to publish */
+        ocre_sensor_value_t deadband; /**< Change threshold in micro-units; 0 to emit every window */
+    } ocre_sensor_agg_config_t;
+
+    /**
+     * Result of one window
+     */
+    typedef struct
+    {
+        ocre_sensor_value_t min;  /**< Smallest sample */
+        ocre_sensor_value_t max;  /**< Largest sample */
+        ocre_sensor_value_t mean; /**< Arithmetic mean */
+        ocre_sensor_value_t rms;  /**< Root mean square */
+        uint32_t count;           /**< Samples in the window */
+        uint64_t start_ns;        /**< Timestamp of the first sample */
+        uint64_t end_ns;          /**< Timestamp of the last sample */
+    } ocre_sensor_agg_result_t;
+
+    /**
+     * Aggregation stage for one sensor channel
+     *
+     * Runs in the caller's storage without allocating. Fields other than
+     * @c result, @c emitted and @c suppressed are internal.
+     */
+    typedef struct
+    {
+        ocre_sensor_agg_config_t config;
+        char topic[OCRE_MAX_TOPIC_LEN];  /**< Empty if results are not published */
+        uint32_t skip;                   /**< Raw samples left to drop before the next kept one */
+        uint32_t count;                  /**< Samples in the current window */
+        uint32_t since_result;           /**< Samples since the last sliding window result */
+        uint32_t head;                   /**< Next slot of @c values */
+        ocre_sensor_value_t min;         /**< Tumbling window running minimum */
+        ocre_sensor_value_t max;         /**< Tumbling window running maximum */
+        int64_t sum;                     /**< Tumbling window running sum */
+        double sum_sq;                   /**< Tumbling window running sum of squares */
+        uint64_t start_ns;               /**< Tumbling window first timestamp */
+        uint64_t end_ns;                 /**< Latest timestamp */
+        ocre_sensor_value_t last;        /**< Latest sample */
+        bool has_reference;              /**< Set once a result was emitted */
+        ocre_sensor_value_t reference;   /**< Latest sample of the last emitted result, for the deadband */
+        ocre_sensor_value_t values[CONFIG_OCRE_SENSOR_AGG_WINDOW_MAX]; /**< Sliding window samples */
+        uint64_t timestamps[CONFIG_OCRE_SENSOR_AGG_WINDOW_MAX];        /**< Sliding window timestamps */
+        ocre_sensor_agg_result_t result; /**< Latest emitted result */
+        uint32_t emitted;                /**< Results emitted */
+        uint32_t suppressed;             /**< Closed windows withheld by the deadband */
+    } ocre_sensor_agg_t;
+
+    /**
+     * Initialize an aggregation stage
+     *
+     * Results are published on @p topic as a CBOR map (OCRE_CONTENT_TYPE_CBOR)
+     * with the keys "min", "max", "mean" and "rms" selected by @c stats, in units
+     * of the channel as floating-point numbers, plus "n", the sample count, and
+     * "t", the timestamp of the last sample in nanoseconds.
+     * @param agg Stage to initialize
+     * @param config Configuration, copied into @p agg
+     * @param topic Topic for results, shorter than OCRE_MAX_TOPIC_LEN; NULL to only keep @c agg->result
+     * @return OCRE_SUCCESS on success, OCRE_ERROR_INVALID on a bad configuration
+     */
+    int ocre_sensor_agg_init(ocre_sensor_agg_t *agg, const ocre_sensor_agg_config_t *config, const char *topic);
+
+    /**
+     * Discard the current window and the deadband reference
+     * @param agg Initialized stage
+     */
+    void ocre_sensor_agg_reset(ocre_sensor_agg_t *agg);
+
+    /**
+     * Feed one raw sample
+     * @param agg Initialized stage
+     * @param value Sample in micro-units
+     * @param timestamp_ns Time the sample was taken, e.g. from ocre_sensors_read_multi()
+     * @return 1 if a result was emitted, 0 if not, negative error code if publishing failed
+     */
+    int ocre_sensor_agg_add(ocre_sensor_agg_t *agg, ocre_sensor_value_t value, uint64_t timestamp_ns);
+
+    /**
+     * Read one channel of a sensor and feed the sample
+     * @param agg Initialized stage
+     * @param sensor_id ID of the sensor
+     * @param channel_type Type of the channel to read
+     * @return 1 if a result was emitted, 0 if not, negative error code on failure
+     */
+    int ocre_sensor_agg_sample(ocre_sensor_agg_t *agg, int sensor_id, int channel_type);
+
+    /**
+     * Emit the partial tumbling window, or the current sliding window, regardless of the deadband
+     * @param agg Initialized stage
+     * @return 1 if a result was emitted, 0 if the window is empty, negative error code if publishing failed
+     */
+    int ocre_sensor_agg_flush(ocre_sensor_agg_t *agg);
+
     /**
      * Register a dispatcher for a resource type
      * @param type Resource type to register the dispatcher for
@@ -0,0 +1,539 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include <float.h>
+#include <string.h>
+
+enum
+{
+    CBOR_MAJOR_UINT = 0,
+    CBOR_MAJOR_NEGINT = 1,
+    CBOR_MAJOR_BYTES = 2,
+    CBOR_MAJOR_TEXT = 3,
+    CBOR_MAJOR_ARRAY = 4,
+    CBOR_MAJOR_MAP = 5,
+    CBOR_MAJOR_TAG = 6,
+    CBOR_MAJOR_SIMPLE = 7,
+};
+
+#define CBOR_FALSE 20
+#define CBOR_TRUE 21
+#define CBOR_NULL 22
+#define CBOR_UNDEFINED 23
+#define CBOR_HALF 25
+#define CBOR_FLOAT 26
+#define CBOR_DOUBLE 27
+
+// =============================================================================
+// ENCODER
+// =============================================================================
+
+static int cbor_fail(ocre_cbor_writer_t *writer, int error)
+{
+    if (writer->error == OCRE_SUCCESS)
+    {
+        writer->error = error;
+    }
+    return writer->error;
+}
+
+static int cbor_write(ocre_cbor_writer_t *writer, const void *data, size_t len)
+{
+    if (writer->error != OCRE_SUCCESS)
+    {
+        return writer->error;
+    }
+    if (len > writer->size - writer->len)
+    {
+        return cbor_fail(writer, OCRE_ERROR_NO_MEMORY);
+    }
+    memcpy(writer->buf + writer->len, data, len);
+    writer->len += len;
+    return OCRE_SUCCESS;
+}
+
+// Writes the initial byte and big-endian argument in its shortest form
+static int cbor_write_head(ocre_cbor_writer_t *writer, uint8_t major, uint64_t arg)
+{
+    uint8_t head[9];
+    size_t len;
+
+    if (arg < 24)
+    {
+        head[0] = (uint8_t)(major << 5 | arg);
+        len = 1;
+    }
+    else
+    {
+        int bytes = arg <= UINT8_MAX ? 1 : arg <= UINT16_MAX ? 2 : arg <= UINT32_MAX ? 4 : 8;
+        head[0] = (uint8_t)(major << 5 | (bytes == 1 ? 24 : bytes == 2 ? 25 : bytes == 4 ? 26 : 27));
+        for (int i = 0; i < bytes; i++)
+        {
+            head[bytes - i] = (uint8_t)(arg >> (8 * i));
+        }
+        len = 1 + bytes;
+    }
+    return cbor_write(writer, head, len);
+}
+
+void ocre_cbor_writer_init(ocre_cbor_writer_t *writer, void *buf, size_t size)
+{
+    writer->buf = buf;
+    writer->size = buf ? size : 0;
+    writer->len = 0;
+    writer->error = OCRE_SUCCESS;
+}
+
+int ocre_cbor_put_uint(ocre_cbor_writer_t *writer, uint64_t value)
+{
+    return cbor_write_head(writer, CBOR_MAJOR_UINT, value);
+}
+
+int ocre_cbor_put_int(ocre_cbor_writer_t *writer, int64_t value)
+{
+    if (value >= 0)
+    {
+        return cbor_write_head(writer, CBOR_MAJOR_UINT, (uint64_t)value);
+    }
+    return cbor_write_head(writer, CBOR_MAJOR_NEGINT, (uint64_t)(-1 - value));
+}
+
+int ocre_cbor_put_float(ocre_cbor_writer_t *writer, double value)
+{
+    uint8_t out[9];
+    size_t len;
+
+    if (value != value)
+    {
+        // Canonical half-precision NaN
+        out[0] = CBOR_MAJOR_SIMPLE << 5 | CBOR_HALF;
+        out[1] = 0x7e;
+        out[2] = 0x00;
+        len = 3;
+    }
+    // Converting a finite double outside the float range is undefined, so only narrow values float can hold
+    else if (__builtin_isinf(value) || (value >= -FLT_MAX && value <= FLT_MAX && (double)(float)value == value))
+    {
+        float f = (float)value;
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        out[0] = CBOR_MAJOR_SIMPLE << 5 | CBOR_FLOAT;
+        for (int i = 0; i < 4; i++)
+        {
+            out[4 - i] = (uint8_t)(bits >> (8 * i));
+        }
+        len = 5;
+    }
+    else
+    {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        out[0] = CBOR_MAJOR_SIMPLE << 5 | CBOR_DOUBLE;
+        for (int i = 0; i < 8; i++)
+        {
+            out[8 - i] = (uint8_t)(bits >> (8 * i));
+        }
+        len = 9;
+    }
+    return cbor_write(writer, out, len);
+}
+
+int ocre_cbor_put_bool(ocre_cbor_writer_t *writer, bool value)
+{
+    return cbor_write_head(writer, CBOR_MAJOR_SIMPLE, value ? CBOR_TRUE : CBOR_FALSE);
+}
+
+int ocre_cbor_put_null(ocre_cbor_writer_t *writer)
+{
+    return cbor_write_head(writer, CBOR_MAJOR_SIMPLE, CBOR_NULL);
+}
+
+int ocre_cbor_put_text(ocre_cbor_writer_t *writer, const char *text)
+{
+    if (text == NULL)
+    {
+        return cbor_fail(writer, OCRE_ERROR_INVALID);
+    }
+    return ocre_cbor_put_text_len(writer, text, strlen(text));
+}
+
+int ocre_cbor_put_text_len(ocre_cbor_writer_t *writer, const char *text, size_t len)
+{
+    if (text == NULL && len > 0)
+    {
+        return cbor_fail(writer, OCRE_ERROR_INVALID);
+    }
+    cbor_write_head(writer, CBOR_MAJOR_TEXT, len);
+    return cbor_write(writer, text, len);
+}
+
+int ocre_cbor_put_bytes(ocre_cbor_writer_t *writer, const void *data, size_t len)
+{
+    if (data == NULL && len > 0)
+    {
+        return cbor_fail(writer, OCRE_ERROR_INVALID);
+    }
+    cbor_write_head(writer, CBOR_MAJOR_BYTES, len);
+    return cbor_write(writer, data, len);
+}
+
+int ocre_cbor_put_array(ocre_cbor_writer_t *writer, size_t count)
+{
+    return cbor_write_head(writer, CBOR_MAJOR_ARRAY, count);
+}
+
+int ocre_cbor_put_map(ocre_cbor_writer_t *writer, size_t count)
+{
+    return cbor_write_head(writer, CBOR_MAJOR_MAP, count);
+}
+
+int ocre_cbor_put_tag(ocre_cbor_writer_t *writer, uint64_t tag)
+{
+    return cbor_write_head(writer, CBOR_MAJOR_TAG, tag);
+}
+
+int ocre_cbor_publish(char *topic, const ocre_cbor_writer_t *writer)
+{
+    if (writer == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    if (writer->error != OCRE_SUCCESS)
+    {
+        return writer->error;
+    }
+    return ocre_publish_message(topic, OCRE_CONTENT_TYPE_CBOR, writer->buf, (int)writer->len);
+}
+
+// =============================================================================
+// DECODER
+// =============================================================================
+
+// Half precision is only decoded; converted through single precision bits
+static double cbor_half_to_double(uint16_t half)
+{
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exp = (half >> 10) & 0x1f;
+    uint32_t mant = half & 0x3ff;
+    uint32_t bits;
+    float f;
+
+    if (exp == 0)
+    {
+        // Zero or subnormal: mant * 2^-24
+        f = (float)mant * (1.0f / 16777216.0f);
+        return sign ? -(double)f : (double)f;
+    }
+
+    bits = sign | (exp == 31 ? 0xffu : exp - 15 + 127) << 23 | mant << 13;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+int ocre_cbor_next(ocre_cbor_reader_t *reader, ocre_cbor_item_t *item)
+{
+    if (reader == NULL || item == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    size_t pos = reader->pos;
+    if (pos >= reader->size)
+    {
+        return OCRE_ERROR_NOT_FOUND;
+    }
+
+    uint8_t initial = reader->buf[pos++];
+    uint8_t major = initial >> 5;
+    uint8_t info = initial & 0x1f;
+    uint64_t arg = info;
+
+    if (info >= 24)
+    {
+        if (info > 27)
+        {
+            return OCRE_ERROR_INVALID; // Reserved or indefinite length
+        }
+        size_t bytes = (size_t)1 << (info - 24);
+        if (bytes > reader->size - pos)
+        {
+            return OCRE_ERROR_INVALID;
+        }
+        arg = 0;
+        for (size_t i = 0; i < bytes; i++)
+        {
+            arg = arg << 8 | reader->buf[pos++];
+        }
+    }
+
+    switch (major)
+    {
+    case CBOR_MAJOR_UINT:
+        item->type = OCRE_CBOR_UINT;
+        item->v.u = arg;
+        break;
+    case CBOR_MAJOR_NEGINT:
+        if (arg > INT64_MAX)
+        {
+            return OCRE_ERROR_INVALID; // Below INT64_MIN
+        }
+        item->type = OCRE_CBOR_NEGINT;
+        item->v.i = -1 - (int64_t)arg;
+        break;
+    case CBOR_MAJOR_BYTES:
+    case CBOR_MAJOR_TEXT:
+        if (arg > reader->size - pos)
+        {
+            return OCRE_ERROR_INVALID;
+        }
+        item->type = major == CBOR_MAJOR_TEXT ? OCRE_CBOR_TEXT : OCRE_CBOR_BYTES;
+        item->v.str.ptr = reader->buf + pos;
+        item->v.str.len = (size_t)arg;
+        pos += (size_t)arg;
+        break;
+    case CBOR_MAJOR_ARRAY:
+        item->type = OCRE_CBOR_ARRAY;
+        item->v.count = arg;
+        break;
+    case CBOR_MAJOR_MAP:
+        item->type = OCRE_CBOR_MAP;
+        item->v.count = arg;
+        break;
+    case CBOR_MAJOR_TAG:
+        item->type = OCRE_CBOR_TAG;
+        item->v.u = arg;
+        break;
+    default:
+        if (info == CBOR_FALSE || info == CBOR_TRUE)
+        {
+            item->type = OCRE_CBOR_BOOL;
+            item->v.b = info == CBOR_TRUE;
+        }
+        else if (info == CBOR_NULL)
+        {
+            item->type = OCRE_CBOR_NULL;
+        }
+        else if (info == CBOR_UNDEFINED)
+        {
+            item->type = OCRE_CBOR_UNDEFINED;
+        }
+        else if (info == CBOR_HALF)
+        {
+            item->type = OCRE_CBOR_FLOAT;
+            item->v.f = cbor_half_to_double((uint16_t)arg);
+        }
+        else if (info == CBOR_FLOAT)
+        {
+            uint32_t bits = (uint32_t)arg;
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            item->type = OCRE_CBOR_FLOAT;
+            item->v.f = f;
+        }
+        else if (info == CBOR_DOUBLE)
+        {
+            item->type = OCRE_CBOR_FLOAT;
+            memcpy(&item->v.f, &arg, sizeof(item->v.f));
+        }
+        else
+        {
+            return OCRE_ERROR_INVALID; // Unassigned simple value
+        }
+        break;
+    }
+
+    reader->pos = pos;
+    return OCRE_SUCCESS;
+}
+
+void ocre_cbor_reader_init(ocre_cbor_reader_t *reader, const void *buf, size_t size)
+{
+    reader->buf = buf;
+    reader->size = buf ? size : 0;
+    reader->pos = 0;
+}
+
+int ocre_cbor_reader_init_msg(ocre_cbor_reader_t *reader, const ocre_msg_t *msg)
+{
+    if (reader == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    ocre_cbor_reader_init(reader, NULL, 0);
+    if (msg == NULL || msg->content_type == NULL || strcmp(msg->content_type, OCRE_CONTENT_TYPE_CBOR) != 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    ocre_cbor_reader_init(reader, msg->payload, msg->payload_len);
+    return OCRE_SUCCESS;
+}
+
+int ocre_cbor_skip(ocre_cbor_reader_t *reader)
+{
+    if (reader == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    // Containers are skipped iteratively by counting the items still owed
+    ocre_cbor_reader_t r = *reader;
+    ocre_cbor_item_t item;
+    uint64_t remaining = 1;
+
+    while (remaining > 0)
+    {
+        int ret = ocre_cbor_next(&r, &item);
+        if (ret != OCRE_SUCCESS)
+        {
+            return ret == OCRE_ERROR_NOT_FOUND && r.pos != reader->pos ? OCRE_ERROR_INVALID : ret;
+        }
+        remaining--;
+
+        uint64_t owed = item.type == OCRE_CBOR_ARRAY ? item.v.count
+                        : item.type == OCRE_CBOR_MAP ? item.v.count * 2
+                        : item.type == OCRE_CBOR_TAG ? 1
+                                                     : 0;
+        // Every item takes at least one byte, so a count beyond the input is malformed
+        if ((item.type == OCRE_CBOR_MAP && item.v.count > UINT64_MAX / 2) || owed > r.size - r.pos ||
+            remaining + owed > r.size - r.pos)
+        {
+            return OCRE_ERROR_INVALID;
+        }
+        remaining += owed;
+    }
+
+    reader->pos = r.pos;
+    return OCRE_SUCCESS;
+}
+
+int ocre_cbor_get_int(ocre_cbor_reader_t *reader, int64_t *value)
+{
+    if (reader == NULL || value == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    ocre_cbor_reader_t r = *reader;
+    ocre_cbor_item_t item;
+
+    if (ocre_cbor_next(&r, &item) != OCRE_SUCCESS)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    if (item.type == OCRE_CBOR_UINT && item.v.u <= INT64_MAX)
+    {
+        *value = (int64_t)item.v.u;
+    }
+    else if (item.type == OCRE_CBOR_NEGINT)
+    {
+        *value = item.v.i;
+    }
+    else
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    *reader = r;
+    return OCRE_SUCCESS;
+}
+
+int ocre_cbor_get_float(ocre_cbor_reader_t *reader, double *value)
+{
+    if (reader == NULL || value == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    ocre_cbor_reader_t r = *reader;
+    ocre_cbor_item_t item;
+
+    if (ocre_cbor_next(&r, &item) != OCRE_SUCCESS)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    if (item.type == OCRE_CBOR_FLOAT)
+    {
+        *value = item.v.f;
+    }
+    else if (item.type == OCRE_CBOR_UINT)
+    {
+        *value = (double)item.v.u;
+    }
+    else if (item.type == OCRE_CBOR_NEGINT)
+    {
+        *value = (double)item.v.i;
+    }
+    else
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    *reader = r;
+    return OCRE_SUCCESS;
+}
+
+int ocre_cbor_get_text(ocre_cbor_reader_t *reader, const char **text, size_t *len)
+{
+    if (reader == NULL || text == NULL || len == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    ocre_cbor_reader_t r = *reader;
+    ocre_cbor_item_t item;
+
+    if (ocre_cbor_next(&r, &item) != OCRE_SUCCESS || item.type != OCRE_CBOR_TEXT)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    *text = (const char *)item.v.str.ptr;
+    *len = item.v.str.len;
+    *reader = r;
+    return OCRE_SUCCESS;
+}
+
+int ocre_cbor_map_find(const ocre_cbor_reader_t *map, const char *key, ocre_cbor_reader_t *value)
+{
+    if (map == NULL || key == NULL || value == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    ocre_cbor_reader_t r = *map;
+    ocre_cbor_item_t item;
+    size_t key_len = strlen(key);
+
+    if (ocre_cbor_next(&r, &item) != OCRE_SUCCESS || item.type != OCRE_CBOR_MAP)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    for (uint64_t i = 0; i < item.v.count; i++)
+    {
+        ocre_cbor_reader_t k = r;
+        ocre_cbor_item_t key_item;
+
+        if (ocre_cbor_next(&k, &key_item) != OCRE_SUCCESS)
+        {
+            return OCRE_ERROR_INVALID;
+        }
+        if (key_item.type == OCRE_CBOR_TEXT && key_item.v.str.len == key_len &&
+            memcmp(key_item.v.str.ptr, key, key_len) == 0)
+        {
+            *value = k;
+            return OCRE_SUCCESS;
+        }
+
+        // Keys may be containers themselves; skip key and value as whole items
+        if (ocre_cbor_skip(&r) != OCRE_SUCCESS || ocre_cbor_skip(&r) != OCRE_SUCCESS)
+        {
+            return OCRE_ERROR_INVALID;
+        }
+    }
+
+    return OCRE_ERROR_NOT_FOUND;
+}
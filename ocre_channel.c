@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include <stddef.h>
+#include <string.h>
+
+_Static_assert(offsetof(ocre_channel_ring_t, head) == 64 && offsetof(ocre_channel_ring_t, tail) == 128,
+               "channel indices must sit on separate 64-byte lines");
+
+static uint8_t *channel_slot(const ocre_channel_ring_t *ring, uint32_t index)
+{
+    return (uint8_t *)ring->slots + (size_t)(index & (ring->capacity - 1)) * ring->slot_size;
+}
+
+// Wake the other end if it asked to be woken; the exchange lets only one side send the signal
+static void channel_wake_peer(ocre_channel_t *channel, uint32_t *waiting)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(waiting, __ATOMIC_RELAXED) && __atomic_exchange_n(waiting, 0, __ATOMIC_ACQ_REL))
+    {
+        int ret = ocre_channel_signal(channel->id);
+        if (ret != OCRE_SUCCESS)
+        {
+            OCRE_LOG_WRN("Failed to signal channel %d peer (%d)\n", (int)channel->id, ret);
+        }
+    }
+}
+
+// Ask to be woken, then look again so an index update racing with the request is not missed
+static void channel_arm(uint32_t *waiting)
+{
+    __atomic_store_n(waiting, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static bool channel_is(const ocre_channel_t *channel, ocre_channel_role_t role)
+{
+    return channel != NULL && channel->ring != NULL && channel->role == (int32_t)role;
+}
+
+int ocre_channel_open(ocre_channel_t *channel, const char *name, ocre_channel_role_t role, uint32_t capacity,
+                      uint32_t msg_size)
+{
+    if (channel == NULL || name == NULL || strlen(name) >= OCRE_MAX_CHANNEL_NAME_LEN ||
+        (role != OCRE_CHANNEL_PRODUCER && role != OCRE_CHANNEL_CONSUMER) || capacity == 0 ||
+        (capacity & (capacity - 1)) != 0 || msg_size == 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    channel->ring = NULL;
+    channel->id = -1;
+    channel->role = (int32_t)role;
+
+    ocre_channel_ring_t *ring = NULL;
+    int id = ocre_channel_attach(name, (int)role, capacity, msg_size, &ring);
+    if (id < 0)
+    {
+        OCRE_LOG_ERR("Failed to attach to channel %s (%d)\n", name, id);
+        return id;
+    }
+
+    if (ring == NULL || ring->version != OCRE_CHANNEL_VERSION || ring->capacity != capacity ||
+        ring->msg_size != msg_size || ring->slot_size != OCRE_CHANNEL_SLOT_SIZE(msg_size))
+    {
+        OCRE_LOG_ERR("Channel %s has an incompatible layout\n", name);
+        ocre_channel_detach(id);
+        return OCRE_ERROR_INVALID;
+    }
+
+    channel->ring = ring;
+    channel->id = id;
+    OCRE_LOG_INF("Opened channel %s as %s (ID %d)\n", name, role == OCRE_CHANNEL_PRODUCER ? "producer" : "consumer",
+                 id);
+    return OCRE_SUCCESS;
+}
+
+int ocre_channel_close(ocre_channel_t *channel)
+{
+    if (channel == NULL || channel->ring == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    int ret = ocre_channel_detach(channel->id);
+    channel->ring = NULL;
+    channel->id = -1;
+    return ret;
+}
+
+int ocre_channel_send(ocre_channel_t *channel, const void *data, uint32_t len)
+{
+    if (!channel_is(channel, OCRE_CHANNEL_PRODUCER) || (data == NULL && len > 0))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    ocre_channel_ring_t *ring = channel->ring;
+    if (len > ring->msg_size)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    uint32_t head = ring->head;
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= ring->capacity)
+    {
+        channel_arm(&ring->producer_waiting);
+        if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= ring->capacity)
+        {
+            return OCRE_ERROR_BUSY;
+        }
+    }
+
+    uint8_t *slot = channel_slot(ring, head);
+    memcpy(slot, &len, sizeof(len));
+    if (len > 0)
+    {
+        memcpy(slot + sizeof(len), data, len);
+    }
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+
+    channel_wake_peer(channel, &ring->consumer_waiting);
+    return OCRE_SUCCESS;
+}
+
+int ocre_channel_peek(ocre_channel_t *channel, const void **data, uint32_t *len)
+{
+    if (!channel_is(channel, OCRE_CHANNEL_CONSUMER) || data == NULL || len == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    ocre_channel_ring_t *ring = channel->ring;
+    uint32_t tail = ring->tail;
+    if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail)
+    {
+        channel_arm(&ring->consumer_waiting);
+        if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail)
+        {
+            return OCRE_ERROR_NOT_FOUND;
+        }
+    }
+
+    const uint8_t *slot = channel_slot(ring, tail);
+    uint32_t msg_len;
+    memcpy(&msg_len, slot, sizeof(msg_len));
+    if (msg_len > ring->msg_size)
+    {
+        msg_len = ring->msg_size; // Never read past the slot, even if the producer misbehaves
+    }
+
+    *data = slot + sizeof(msg_len);
+    *len = msg_len;
+    return OCRE_SUCCESS;
+}
+
+int ocre_channel_consume(ocre_channel_t *channel)
+{
+    if (!channel_is(channel, OCRE_CHANNEL_CONSUMER))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    ocre_channel_ring_t *ring = channel->ring;
+    uint32_t tail = ring->tail;
+    if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail)
+    {
+        return OCRE_ERROR_NOT_FOUND;
+    }
+
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    channel_wake_peer(channel, &ring->producer_waiting);
+    return OCRE_SUCCESS;
+}
+
+int ocre_channel_recv(ocre_channel_t *channel, void *buf, uint32_t size)
+{
+    const void *data;
+    uint32_t len;
+
+    int ret = ocre_channel_peek(channel, &data, &len);
+    if (ret != OCRE_SUCCESS)
+    {
+        return ret;
+    }
+    if (len > size || (buf == NULL && len > 0))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    if (len > 0)
+    {
+        memcpy(buf, data, len);
+    }
+    ocre_channel_consume(channel);
+    return (int)len;
+}
+
+int ocre_channel_available(const ocre_channel_t *channel)
+{
+    if (channel == NULL || channel->ring == NULL)
+    {
+        return 0;
+    }
+
+    const ocre_channel_ring_t *ring = channel->ring;
+    return (int)(__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE));
+}
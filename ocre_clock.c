@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include <time.h>
+
+typedef enum
+{
+    CLOCK_UNREGISTERED,
+    CLOCK_SHARED,
+    CLOCK_LOCAL, // Runtime has no time page; read clock_gettime()
+} clock_mode_t;
+
+static ocre_time_page_t time_page = {.version = OCRE_TIME_PAGE_VERSION};
+static clock_mode_t clock_mode = CLOCK_UNREGISTERED;
+
+static void clock_register(void)
+{
+    int ret = ocre_time_page_register(&time_page);
+    if (ret == OCRE_SUCCESS)
+    {
+        clock_mode = CLOCK_SHARED;
+        return;
+    }
+
+    OCRE_LOG_WRN("Time page not supported by runtime (%d), using clock_gettime\n", ret);
+    clock_mode = CLOCK_LOCAL;
+}
+
+// Seqlock read: retry while the runtime is mid-update or updated during the read
+static uint64_t time_page_read(void)
+{
+    uint32_t seq;
+    uint64_t ns;
+
+    do
+    {
+        seq = __atomic_load_n(&time_page.seq, __ATOMIC_ACQUIRE);
+        ns = __atomic_load_n(&time_page.monotonic_ns, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1) || seq != __atomic_load_n(&time_page.seq, __ATOMIC_RELAXED));
+
+    return ns;
+}
+
+uint64_t ocre_clock_monotonic_ns(void)
+{
+    if (clock_mode == CLOCK_UNREGISTERED)
+    {
+        clock_register();
+    }
+
+    if (clock_mode == CLOCK_SHARED)
+    {
+        return time_page_read();
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t ocre_clock_monotonic_ms(void)
+{
+    return ocre_clock_monotonic_ns() / 1000000u;
+}
+
+bool ocre_clock_is_shared(void)
+{
+    if (clock_mode == CLOCK_UNREGISTERED)
+    {
+        clock_register();
+    }
+    return clock_mode == CLOCK_SHARED;
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include <string.h>
+
+_Static_assert((CONFIG_OCRE_GPIO_CAPTURE_DEPTH & (CONFIG_OCRE_GPIO_CAPTURE_DEPTH - 1)) == 0,
+               "CONFIG_OCRE_GPIO_CAPTURE_DEPTH must be a power of two");
+
+int ocre_gpio_capture_open(ocre_gpio_capture_t *capture, int port, int pin, ocre_gpio_edge_mode_t edges,
+                           int notify_every, int window_ms)
+{
+    if (capture == NULL || (edges & ~OCRE_GPIO_EDGE_BOTH) != 0 || edges == 0 || notify_every < 0 ||
+        notify_every > CONFIG_OCRE_GPIO_CAPTURE_DEPTH || window_ms < 0 || (notify_every == 0 && window_ms == 0))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    memset(capture, 0, sizeof(*capture));
+    capture->version = OCRE_GPIO_CAPTURE_VERSION;
+    capture->capacity = CONFIG_OCRE_GPIO_CAPTURE_DEPTH;
+    capture->id = -1;
+    capture->port = port;
+    capture->pin = pin;
+    capture->edge_mode = (int32_t)edges;
+
+    int id = ocre_gpio_capture_start(port, pin, (int)edges, notify_every, window_ms, capture);
+    if (id < 0)
+    {
+        OCRE_LOG_ERR("Failed to start capture on GPIO port %d pin %d (%d)\n", port, pin, id);
+        return id;
+    }
+
+    capture->id = id;
+    OCRE_LOG_INF("Capturing GPIO port %d pin %d (ID %d)\n", port, pin, id);
+    return OCRE_SUCCESS;
+}
+
+int ocre_gpio_capture_close(ocre_gpio_capture_t *capture)
+{
+    if (capture == NULL || capture->id < 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    int ret = ocre_gpio_capture_stop(capture->id);
+    capture->id = -1;
+    return ret;
+}
+
+int ocre_gpio_capture_available(const ocre_gpio_capture_t *capture)
+{
+    if (capture == NULL)
+    {
+        return 0;
+    }
+
+    uint32_t head = __atomic_load_n(&capture->head, __ATOMIC_ACQUIRE);
+    return (int)(head - capture->tail);
+}
+
+int ocre_gpio_capture_read(ocre_gpio_capture_t *capture, ocre_gpio_edge_t *edges, int max_edges)
+{
+    if (capture == NULL || edges == NULL || max_edges < 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    uint32_t tail = capture->tail;
+    uint32_t head = __atomic_load_n(&capture->head, __ATOMIC_ACQUIRE);
+    int count = 0;
+
+    while (tail != head && count < max_edges)
+    {
+        edges[count++] = capture->edges[tail & (CONFIG_OCRE_GPIO_CAPTURE_DEPTH - 1)];
+        tail++;
+    }
+
+    __atomic_store_n(&capture->tail, tail, __ATOMIC_RELEASE);
+    return count;
+}
+
+// =============================================================================
+// PULSE MEASUREMENT
+// =============================================================================
+
+void ocre_gpio_pulse_reset(ocre_gpio_pulse_t *pulse)
+{
+    if (pulse)
+    {
+        memset(pulse, 0, sizeof(*pulse));
+        pulse->level = -1;
+    }
+}
+
+static int32_t pulse_width_us(uint64_t width_ns, int level)
+{
+    uint64_t us = width_ns / 1000u;
+    if (us > INT32_MAX)
+    {
+        us = INT32_MAX;
+    }
+    return level ? (int32_t)us : -(int32_t)us;
+}
+
+int ocre_gpio_pulse_update(ocre_gpio_capture_t *capture, ocre_gpio_pulse_t *pulse, int32_t *widths_us,
+                           int max_widths)
+{
+    if (capture == NULL || pulse == NULL || (widths_us == NULL && max_widths > 0) || max_widths < 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    uint32_t tail = capture->tail;
+    uint32_t head = __atomic_load_n(&capture->head, __ATOMIC_ACQUIRE);
+    int widths = 0;
+    int count = 0;
+
+    // A falling-only capture never sees a rising edge, so its pulses are counted on the falling edges
+    int counted_level = capture->edge_mode == OCRE_GPIO_EDGE_FALLING ? 0 : 1;
+
+    for (; tail != head; tail++, count++)
+    {
+        const ocre_gpio_edge_t *edge = &capture->edges[tail & (CONFIG_OCRE_GPIO_CAPTURE_DEPTH - 1)];
+        uint64_t t = edge->timestamp_ns;
+        int level = edge->state ? 1 : 0;
+
+        if (pulse->level >= 0)
+        {
+            if (widths_us)
+            {
+                if (widths == max_widths)
+                {
+                    break;
+                }
+                widths_us[widths++] = pulse_width_us(t - pulse->last_edge_ns, pulse->level);
+            }
+
+            // Only a change of level closes a phase; single-edge captures repeat the same level
+            if (pulse->level && !level)
+            {
+                pulse->high_ns = t - pulse->last_edge_ns;
+            }
+            else if (!pulse->level && level)
+            {
+                pulse->low_ns = t - pulse->last_edge_ns;
+            }
+        }
+
+        if (level == counted_level)
+        {
+            if (pulse->pulses == 0)
+            {
+                pulse->first_rise_ns = t;
+            }
+            else
+            {
+                pulse->period_ns = t - pulse->last_rise_ns;
+            }
+            pulse->last_rise_ns = t;
+            pulse->pulses++;
+        }
+
+        pulse->last_edge_ns = t;
+        pulse->level = level;
+    }
+
+    __atomic_store_n(&capture->tail, tail, __ATOMIC_RELEASE);
+    return count;
+}
+
+uint32_t ocre_gpio_pulse_frequency_mhz(const ocre_gpio_pulse_t *pulse)
+{
+    if (pulse == NULL || pulse->pulses < 2 || pulse->last_rise_ns <= pulse->first_rise_ns)
+    {
+        return 0;
+    }
+
+    // Split into whole hertz and remainder so the product cannot overflow 64 bits
+    uint64_t span_ns = pulse->last_rise_ns - pulse->first_rise_ns;
+    uint64_t cycles_e9 = (uint64_t)(pulse->pulses - 1) * 1000000000u;
+    uint64_t mhz = cycles_e9 / span_ns * 1000u + cycles_e9 % span_ns * 1000u / span_ns;
+    return mhz > UINT32_MAX ? UINT32_MAX : (uint32_t)mhz;
+}
+
+uint32_t ocre_gpio_pulse_duty_permille(const ocre_gpio_pulse_t *pulse)
+{
+    if (pulse == NULL || pulse->high_ns == 0 || pulse->low_ns == 0)
+    {
+        return 0;
+    }
+
+    return (uint32_t)(pulse->high_ns * 1000u / (pulse->high_ns + pulse->low_ns));
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+#define LOG_LINE_MAX 160
+#define LOG_MASK (CONFIG_OCRE_LOG_BUFFER_SIZE - 1)
+
+_Static_assert((CONFIG_OCRE_LOG_BUFFER_SIZE & LOG_MASK) == 0,
+               "CONFIG_OCRE_LOG_BUFFER_SIZE must be a power of two");
+
+static ocre_log_buffer_t log_buffer = {.size = CONFIG_OCRE_LOG_BUFFER_SIZE};
+
+static const char log_level_tags[] = {'-', 'E', 'W', 'I', 'D'};
+
+void ocre_log_write(int level, const char *fmt, ...)
+{
+    char line[LOG_LINE_MAX];
+    int len = 0;
+
+    if (level > OCRE_LOG_LEVEL_NONE && level <= OCRE_LOG_LEVEL_DBG)
+    {
+        line[0] = log_level_tags[level];
+        line[1] = ':';
+        line[2] = ' ';
+        len = 3;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(line + len, sizeof(line) - len, fmt, args);
+    va_end(args);
+
+    if (n < 0)
+    {
+        return;
+    }
+
+    len += n;
+    if (len > (int)sizeof(line) - 1)
+    {
+        len = sizeof(line) - 1; // Truncated
+    }
+
+    // Every record ends in exactly one newline
+    if (len == 0 || line[len - 1] != '\n')
+    {
+        if (len == (int)sizeof(line) - 1)
+        {
+            len--;
+        }
+        line[len++] = '\n';
+    }
+
+    uint32_t head = log_buffer.head;
+    for (int i = 0; i < len; i++)
+    {
+        log_buffer.data[(head + i) & LOG_MASK] = line[i];
+    }
+    head += len;
+
+    // Overwrite the oldest records when the ring is full, never leaving a partial line
+    if (head - log_buffer.tail > CONFIG_OCRE_LOG_BUFFER_SIZE)
+    {
+        uint32_t tail = head - CONFIG_OCRE_LOG_BUFFER_SIZE;
+        while (tail != head && log_buffer.data[tail & LOG_MASK] != '\n')
+        {
+            tail++;
+        }
+        tail++;
+
+        log_buffer.dropped += tail - log_buffer.tail;
+        log_buffer.tail = tail;
+    }
+    log_buffer.head = head;
+}
+
+size_t ocre_log_read(char *buf, size_t len)
+{
+    size_t count = 0;
+
+    while (count < len && log_buffer.tail != log_buffer.head)
+    {
+        buf[count++] = log_buffer.data[log_buffer.tail & LOG_MASK];
+        log_buffer.tail++;
+    }
+
+    return count;
+}
+
+OCRE_EXPORT("ocre_log_dump") void ocre_log_dump(void)
+{
+    char chunk[LOG_LINE_MAX];
+    size_t n;
+
+    if (log_buffer.dropped)
+    {
+        printf("[%u log bytes dropped]\n", (unsigned)log_buffer.dropped);
+        log_buffer.dropped = 0;
+    }
+
+    while ((n = ocre_log_read(chunk, sizeof(chunk))) > 0)
+    {
+        fwrite(chunk, 1, n, stdout);
+    }
+    fflush(stdout);
+}
+
+ocre_log_buffer_t *ocre_log_get_buffer(void)
+{
+    return &log_buffer;
+}
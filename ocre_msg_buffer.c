@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include <string.h>
+
+// One pool block: the message header followed by the storage its pointers refer to
+typedef struct
+{
+    ocre_msg_t msg;
+    char topic[OCRE_MAX_TOPIC_LEN];
+    char content_type[OCRE_MAX_CONTENT_TYPE_LEN];
+    uint8_t payload[OCRE_MAX_PAYLOAD_LEN] __attribute__((aligned(8)));
+} msg_buffer_t;
+
+_Static_assert(CONFIG_OCRE_MSG_BUFFER_COUNT <= CONFIG_OCRE_POOL_MAX_BLOCKS,
+               "CONFIG_OCRE_MSG_BUFFER_COUNT exceeds CONFIG_OCRE_POOL_MAX_BLOCKS");
+
+static msg_buffer_t msg_buffers[CONFIG_OCRE_MSG_BUFFER_COUNT];
+static ocre_pool_t msg_pool;
+static bool msg_pool_ready = false;
+
+static void msg_pool_init(void)
+{
+    if (!msg_pool_ready)
+    {
+        ocre_pool_init(&msg_pool, msg_buffers, sizeof(msg_buffers), sizeof(msg_buffers[0]));
+        msg_pool_ready = true;
+    }
+}
+
+static int msg_buffer_alloc(msg_buffer_t **buffer)
+{
+    msg_pool_init();
+
+    int ret = ocre_pool_alloc(&msg_pool, (void **)buffer);
+    if (ret != OCRE_SUCCESS)
+    {
+        OCRE_LOG_WRN("Message pool exhausted (%d messages)\n", CONFIG_OCRE_MSG_BUFFER_COUNT);
+        return ret;
+    }
+
+    msg_buffer_t *b = *buffer;
+    b->msg.mid = 0;
+    b->msg.topic = b->topic;
+    b->msg.content_type = b->content_type;
+    b->msg.payload = b->payload;
+    b->msg.payload_len = 0;
+    b->topic[0] = '\0';
+    b->content_type[0] = '\0';
+    return OCRE_SUCCESS;
+}
+
+int ocre_msg_alloc(ocre_msg_t **msg)
+{
+    if (msg == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    msg_buffer_t *buffer;
+    int ret = msg_buffer_alloc(&buffer);
+    *msg = ret == OCRE_SUCCESS ? &buffer->msg : NULL;
+    return ret;
+}
+
+int ocre_msg_copy(const ocre_msg_t *msg, ocre_msg_t **copy)
+{
+    if (msg == NULL || copy == NULL || msg->topic == NULL || msg->content_type == NULL ||
+        (msg->payload == NULL && msg->payload_len > 0))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    size_t topic_len = strlen(msg->topic);
+    size_t content_type_len = strlen(msg->content_type);
+    if (topic_len >= OCRE_MAX_TOPIC_LEN || content_type_len >= OCRE_MAX_CONTENT_TYPE_LEN ||
+        msg->payload_len > OCRE_MAX_PAYLOAD_LEN)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    msg_buffer_t *buffer;
+    int ret = msg_buffer_alloc(&buffer);
+    if (ret != OCRE_SUCCESS)
+    {
+        *copy = NULL;
+        return ret;
+    }
+
+    buffer->msg.mid = msg->mid;
+    memcpy(buffer->topic, msg->topic, topic_len + 1);
+    memcpy(buffer->content_type, msg->content_type, content_type_len + 1);
+    if (msg->payload_len > 0)
+    {
+        memcpy(buffer->payload, msg->payload, msg->payload_len);
+    }
+    buffer->msg.payload_len = msg->payload_len;
+
+    *copy = &buffer->msg;
+    return OCRE_SUCCESS;
+}
+
+int ocre_msg_free(ocre_msg_t *msg)
+{
+    // msg is the first member, so the message address is the block address
+    if (msg == NULL || !msg_pool_ready)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    return ocre_pool_free(&msg_pool, msg);
+}
+
+int ocre_msg_buffer_stats(ocre_pool_stats_t *stats)
+{
+    msg_pool_init();
+    return ocre_pool_get_stats(&msg_pool, stats);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include <string.h>
+
+#define PRED_OP_MASK 0x7F
+
+void ocre_msg_filter_init(ocre_msg_filter_t *filter)
+{
+    if (filter)
+    {
+        memset(filter, 0, sizeof(*filter));
+        filter->version = OCRE_MSG_FILTER_VERSION;
+    }
+}
+
+int ocre_msg_filter_content_type(ocre_msg_filter_t *filter, const char *content_type)
+{
+    if (filter == NULL || (content_type && strlen(content_type) >= OCRE_MAX_CONTENT_TYPE_LEN))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    strcpy(filter->content_type, content_type ? content_type : "");
+    return OCRE_SUCCESS;
+}
+
+// Store the low @p len bytes of an integer in the field's byte order
+static void pred_store(uint8_t *dst, uint64_t value, uint32_t len, bool little_endian)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        dst[little_endian ? i : len - 1 - i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint64_t pred_load(const uint8_t *src, const uint8_t *mask, uint32_t len, bool little_endian)
+{
+    uint64_t value = 0;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        uint32_t index = little_endian ? len - 1 - i : i;
+        value = (value << 8) | (uint8_t)(src[index] & mask[index]);
+    }
+    return value;
+}
+
+int ocre_msg_filter_add_predicate(ocre_msg_filter_t *filter, uint32_t offset, uint32_t len, int op,
+                                  uint64_t value, uint64_t mask)
+{
+    if (filter == NULL || len == 0 || len > OCRE_MSG_PRED_MAX_LEN || offset > UINT16_MAX ||
+        (op & ~(PRED_OP_MASK | OCRE_MSG_PRED_LITTLE_ENDIAN)) != 0 || (op & PRED_OP_MASK) > OCRE_MSG_PRED_GT)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    if (filter->predicate_count >= CONFIG_OCRE_MSG_FILTER_MAX_PREDICATES)
+    {
+        return OCRE_ERROR_NO_MEMORY;
+    }
+
+    ocre_msg_predicate_t *pred = &filter->predicates[filter->predicate_count++];
+    bool little_endian = (op & OCRE_MSG_PRED_LITTLE_ENDIAN) != 0;
+
+    memset(pred, 0, sizeof(*pred));
+    pred->offset = (uint16_t)offset;
+    pred->len = (uint8_t)len;
+    pred->op = (uint8_t)op;
+    pred_store(pred->value, value, len, little_endian);
+    pred_store(pred->mask, mask, len, little_endian);
+    return OCRE_SUCCESS;
+}
+
+static bool pred_match(const ocre_msg_predicate_t *pred, const ocre_msg_t *msg)
+{
+    if (pred->len == 0 || pred->len > OCRE_MSG_PRED_MAX_LEN || msg->payload == NULL ||
+        (uint32_t)pred->offset + pred->len > msg->payload_len)
+    {
+        return false;
+    }
+
+    bool little_endian = (pred->op & OCRE_MSG_PRED_LITTLE_ENDIAN) != 0;
+    uint64_t field = pred_load((const uint8_t *)msg->payload + pred->offset, pred->mask, pred->len, little_endian);
+    uint64_t value = pred_load(pred->value, pred->mask, pred->len, little_endian);
+
+    switch (pred->op & PRED_OP_MASK)
+    {
+    case OCRE_MSG_PRED_EQ:
+        return field == value;
+    case OCRE_MSG_PRED_NE:
+        return field != value;
+    case OCRE_MSG_PRED_LT:
+        return field < value;
+    case OCRE_MSG_PRED_GT:
+        return field > value;
+    default:
+        return false;
+    }
+}
+
+bool ocre_msg_filter_match(const ocre_msg_filter_t *filter, const ocre_msg_t *msg)
+{
+    if (filter == NULL || msg == NULL || filter->version != OCRE_MSG_FILTER_VERSION ||
+        filter->predicate_count > CONFIG_OCRE_MSG_FILTER_MAX_PREDICATES)
+    {
+        return false;
+    }
+
+    if (filter->content_type[0] != '\0' &&
+        (msg->content_type == NULL ||
+         strncmp(filter->content_type, msg->content_type, OCRE_MAX_CONTENT_TYPE_LEN) != 0))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < filter->predicate_count; i++)
+    {
+        if (!pred_match(&filter->predicates[i], msg))
+        {
+            return false;
+        }
+    }
+    return true;
+}
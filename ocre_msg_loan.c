@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+
+static ocre_msg_pool_t msg_pool = {
+    .version = OCRE_MSG_POOL_VERSION,
+    .buffer_count = CONFIG_OCRE_MSG_LOAN_BUFFERS,
+    .buffer_size = CONFIG_OCRE_MSG_LOAN_BUFFER_SIZE,
+};
+
+typedef enum
+{
+    POOL_UNREGISTERED,
+    POOL_SHARED,
+    POOL_LOCAL, // Runtime has no pool support; publish by copy
+} pool_mode_t;
+
+static pool_mode_t pool_mode = POOL_UNREGISTERED;
+
+static void pool_register(void)
+{
+    int ret = ocre_msg_pool_register(&msg_pool);
+    if (ret == OCRE_SUCCESS)
+    {
+        pool_mode = POOL_SHARED;
+        return;
+    }
+
+    OCRE_LOG_WRN("Message pool not supported by runtime (%d), publishing by copy\n", ret);
+    pool_mode = POOL_LOCAL;
+}
+
+// Drop one reference; a reference count never goes below zero, so a double release cannot leak the buffer
+static void pool_put(uint32_t index)
+{
+    uint32_t refs = __atomic_load_n(&msg_pool.refcount[index], __ATOMIC_RELAXED);
+    do
+    {
+        if (refs == 0)
+        {
+            OCRE_LOG_ERR("Message buffer %u released more often than loaned\n", (unsigned)index);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&msg_pool.refcount[index], &refs, refs - 1, true, __ATOMIC_RELEASE,
+                                          __ATOMIC_RELAXED));
+}
+
+// Copies published without pool support must fit ocre_publish_message()
+static uint32_t pool_capacity(void)
+{
+    return pool_mode == POOL_LOCAL && OCRE_MAX_PAYLOAD_LEN < CONFIG_OCRE_MSG_LOAN_BUFFER_SIZE
+               ? OCRE_MAX_PAYLOAD_LEN
+               : CONFIG_OCRE_MSG_LOAN_BUFFER_SIZE;
+}
+
+int ocre_msg_loan(uint32_t size, ocre_msg_loan_t *loan)
+{
+    if (loan == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    loan->index = -1;
+    loan->data = NULL;
+    loan->capacity = 0;
+
+    if (pool_mode == POOL_UNREGISTERED)
+    {
+        pool_register();
+    }
+
+    if (size > pool_capacity())
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    for (uint32_t i = 0; i < CONFIG_OCRE_MSG_LOAN_BUFFERS; i++)
+    {
+        uint32_t expected = 0;
+        if (__atomic_compare_exchange_n(&msg_pool.refcount[i], &expected, 1, false, __ATOMIC_ACQUIRE,
+                                        __ATOMIC_RELAXED))
+        {
+            loan->index = (int32_t)i;
+            loan->data = msg_pool.buffers[i];
+            loan->capacity = pool_capacity();
+            return OCRE_SUCCESS;
+        }
+    }
+
+    return OCRE_ERROR_NO_MEMORY;
+}
+
+int ocre_msg_publish_loaned(ocre_msg_loan_t *loan, char *topic, char *content_type, uint32_t payload_len)
+{
+    if (loan == NULL || loan->index < 0 || loan->index >= CONFIG_OCRE_MSG_LOAN_BUFFERS)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    uint32_t index = (uint32_t)loan->index;
+    int ret;
+
+    if (payload_len > loan->capacity)
+    {
+        ret = OCRE_ERROR_INVALID;
+    }
+    else if (pool_mode == POOL_SHARED)
+    {
+        // The runtime takes its own references for each delivery before returning
+        ret = ocre_publish_message_loaned(topic, content_type, index, payload_len);
+    }
+    else
+    {
+        ret = ocre_publish_message(topic, content_type, msg_pool.buffers[index], (int)payload_len);
+    }
+
+    ocre_msg_loan_cancel(loan);
+    return ret;
+}
+
+void ocre_msg_loan_cancel(ocre_msg_loan_t *loan)
+{
+    if (loan == NULL || loan->index < 0 || loan->index >= CONFIG_OCRE_MSG_LOAN_BUFFERS)
+    {
+        return;
+    }
+
+    pool_put((uint32_t)loan->index);
+    loan->index = -1;
+    loan->data = NULL;
+    loan->capacity = 0;
+}
+
+void ocre_msg_release(const ocre_msg_t *msg)
+{
+    if (msg == NULL)
+    {
+        return;
+    }
+
+    // The buffer may belong to a producer in another container; only the runtime knows its pool
+    int ret = ocre_release_message(msg->mid);
+    if (ret != OCRE_SUCCESS && ret != OCRE_ERROR_NOT_FOUND)
+    {
+        OCRE_LOG_WRN("Failed to release message %u (%d)\n", (unsigned)msg->mid, ret);
+    }
+}
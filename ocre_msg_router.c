@@ -0,0 +1,452 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include <string.h>
+
+#define NODE_NONE -1
+#define ROOT_NODE 0
+
+typedef enum
+{
+    SEGMENT_LITERAL,
+    SEGMENT_PLUS, // '+' matches exactly one level
+    SEGMENT_HASH, // '#' matches the parent level and everything below it
+} segment_kind_t;
+
+// One topic level in the trie. Segment text points into the owning route's filter.
+typedef struct
+{
+    const char *segment;
+    uint32_t hash;
+    uint16_t length;
+    uint8_t kind;
+    int16_t first_child;
+    int16_t next_sibling;
+    int16_t first_route;
+} router_node_t;
+
+// Route records come from a fixed-block pool; the route ID is the block index. The pool's
+// free-list link overlays the start of a free record, so @c used must not come first.
+typedef struct
+{
+    char filter[OCRE_MAX_TOPIC_LEN];
+    uint16_t prefix_len; // Literal part of the filter, up to the first wildcard level
+    bool used;
+    ocre_msg_handler_t handler;
+    void *user_ctx;
+    int16_t next_route; // Next route attached to the same node
+} router_route_t;
+
+_Static_assert(offsetof(router_route_t, used) >= sizeof(void *), "route pool link overlays router_route_t.used");
+_Static_assert(CONFIG_OCRE_MSG_ROUTER_MAX_ROUTES <= CONFIG_OCRE_POOL_MAX_BLOCKS,
+               "CONFIG_OCRE_MSG_ROUTER_MAX_ROUTES exceeds CONFIG_OCRE_POOL_MAX_BLOCKS");
+
+static router_node_t nodes[CONFIG_OCRE_MSG_ROUTER_MAX_NODES];
+static int node_count = 0;
+static router_route_t routes[CONFIG_OCRE_MSG_ROUTER_MAX_ROUTES];
+static ocre_pool_t route_pool;
+
+// Topic prefixes the runtime is subscribed to. None covers another, so each publish reaches the router at most once;
+// removing a route leaves its runtime subscription in place.
+static char host_subscriptions[CONFIG_OCRE_MSG_ROUTER_MAX_ROUTES][OCRE_MAX_TOPIC_LEN];
+static int host_subscription_count = 0;
+
+static uint32_t segment_hash(const char *segment, size_t length)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ (uint8_t)segment[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static int node_alloc(const char *segment, uint16_t length)
+{
+    if (node_count >= CONFIG_OCRE_MSG_ROUTER_MAX_NODES)
+    {
+        return NODE_NONE;
+    }
+
+    router_node_t *node = &nodes[node_count];
+    node->segment = segment;
+    node->length = length;
+    node->hash = segment_hash(segment, length);
+    node->kind = SEGMENT_LITERAL;
+    if (length == 1 && segment[0] == '+')
+    {
+        node->kind = SEGMENT_PLUS;
+    }
+    else if (length == 1 && segment[0] == '#')
+    {
+        node->kind = SEGMENT_HASH;
+    }
+    node->first_child = NODE_NONE;
+    node->next_sibling = NODE_NONE;
+    node->first_route = NODE_NONE;
+    return node_count++;
+}
+
+static void trie_reset(void)
+{
+    node_count = 0;
+    node_alloc("", 0);
+}
+
+static void route_pool_init(void)
+{
+    if (route_pool.storage == NULL)
+    {
+        ocre_pool_init(&route_pool, routes, sizeof(routes), sizeof(routes[0]));
+    }
+}
+
+// Walk or extend the trie along the route's filter and attach the route to the final node
+static int trie_insert(int route_id)
+{
+    router_route_t *route = &routes[route_id];
+    const char *level = route->filter;
+    int parent = ROOT_NODE;
+
+    while (true)
+    {
+        const char *end = strchr(level, '/');
+        uint16_t length = end ? (uint16_t)(end - level) : (uint16_t)strlen(level);
+        uint32_t hash = segment_hash(level, length);
+
+        int child = nodes[parent].first_child;
+        while (child != NODE_NONE)
+        {
+            router_node_t *node = &nodes[child];
+            if (node->hash == hash && node->length == length && memcmp(node->segment, level, length) == 0)
+            {
+                break;
+            }
+            child = node->next_sibling;
+        }
+
+        if (child == NODE_NONE)
+        {
+            child = node_alloc(level, length);
+            if (child == NODE_NONE)
+            {
+                return OCRE_ERROR_NO_MEMORY;
+            }
+            nodes[child].next_sibling = nodes[parent].first_child;
+            nodes[parent].first_child = (int16_t)child;
+        }
+
+        parent = child;
+        if (end == NULL)
+        {
+            break;
+        }
+        level = end + 1;
+    }
+
+    route->next_route = nodes[parent].first_route;
+    nodes[parent].first_route = (int16_t)route_id;
+    return OCRE_SUCCESS;
+}
+
+// Rebuild the trie from the active routes; used after removals so no node refers to freed text
+static void trie_rebuild(void)
+{
+    trie_reset();
+    for (int i = 0; i < CONFIG_OCRE_MSG_ROUTER_MAX_ROUTES; i++)
+    {
+        if (routes[i].used)
+        {
+            trie_insert(i); // Cannot fail: the rebuilt trie is no larger than before
+        }
+    }
+}
+
+// Check MQTT filter syntax and return the length of its literal prefix
+static int filter_validate(const char *filter, size_t length)
+{
+    int prefix_len = -1;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        char c = filter[i];
+        if (c != '+' && c != '#')
+        {
+            continue;
+        }
+
+        // Wildcards must occupy a whole level
+        bool level_start = (i == 0 || filter[i - 1] == '/');
+        bool level_end = (i + 1 == length || filter[i + 1] == '/');
+        if (!level_start || !level_end)
+        {
+            return OCRE_ERROR_INVALID;
+        }
+
+        // '#' must be the last level
+        if (c == '#' && i + 1 != length)
+        {
+            return OCRE_ERROR_INVALID;
+        }
+
+        // The runtime matches plain prefixes, so "a/#" subscribes to "a" to receive "a" itself
+        if (prefix_len < 0)
+        {
+            prefix_len = (c == '#' && i > 0) ? (int)i - 1 : (int)i;
+        }
+    }
+
+    return prefix_len < 0 ? (int)length : prefix_len;
+}
+
+// True if a runtime subscription to @p prefix receives every topic starting with @p literal. Prefixes are compared
+// on level boundaries, so "a" covers "a/b" but not "ab/c".
+static bool host_prefix_covers(const char *prefix, const char *literal, size_t literal_len)
+{
+    size_t length = strlen(prefix);
+    if (length > literal_len || memcmp(prefix, literal, length) != 0)
+    {
+        return false;
+    }
+    return length == 0 || length == literal_len || prefix[length - 1] == '/' || literal[length] == '/';
+}
+
+// Subscribe the runtime to the route's literal prefix unless an earlier subscription covers it. Narrower
+// subscriptions the new prefix covers are dropped, as they would deliver the same publish a second time.
+static int host_subscribe(const router_route_t *route)
+{
+    for (int i = 0; i < host_subscription_count; i++)
+    {
+        if (host_prefix_covers(host_subscriptions[i], route->filter, route->prefix_len))
+        {
+            return OCRE_SUCCESS;
+        }
+    }
+
+    if (host_subscription_count >= CONFIG_OCRE_MSG_ROUTER_MAX_ROUTES)
+    {
+        return OCRE_ERROR_NO_MEMORY;
+    }
+
+    char *prefix = host_subscriptions[host_subscription_count];
+    memcpy(prefix, route->filter, route->prefix_len);
+    prefix[route->prefix_len] = '\0';
+
+    int ret = ocre_subscribe_message(prefix, "ocre_msg_router");
+    if (ret != OCRE_SUCCESS)
+    {
+        return ret;
+    }
+
+    int count = 0;
+    for (int i = 0; i < host_subscription_count; i++)
+    {
+        char *narrower = host_subscriptions[i];
+        if (host_prefix_covers(prefix, narrower, strlen(narrower)))
+        {
+            ret = ocre_unsubscribe_message(narrower, "ocre_msg_router");
+            if (ret == OCRE_SUCCESS)
+            {
+                continue;
+            }
+            OCRE_LOG_WRN("Failed to unsubscribe %s (%d); its topics are routed twice\n", narrower, ret);
+        }
+        if (count != i)
+        {
+            memmove(host_subscriptions[count], narrower, sizeof(host_subscriptions[count]));
+        }
+        count++;
+    }
+    if (count != host_subscription_count)
+    {
+        memmove(host_subscriptions[count], prefix, sizeof(host_subscriptions[count]));
+    }
+    host_subscription_count = count + 1;
+    return OCRE_SUCCESS;
+}
+
+static void deliver_routes(int node_index, const ocre_msg_t *msg, int *delivered)
+{
+    for (int r = nodes[node_index].first_route; r != NODE_NONE; r = routes[r].next_route)
+    {
+        routes[r].handler(msg, routes[r].user_ctx);
+        (*delivered)++;
+    }
+}
+
+static void trie_match(int node_index, const char *level, bool first_level, const ocre_msg_t *msg,
+                       int *delivered)
+{
+    const char *end = strchr(level, '/');
+    uint16_t length = end ? (uint16_t)(end - level) : (uint16_t)strlen(level);
+    uint32_t hash = 0;
+    bool hashed = false;
+
+    for (int child = nodes[node_index].first_child; child != NODE_NONE; child = nodes[child].next_sibling)
+    {
+        router_node_t *node = &nodes[child];
+
+        // Wildcards never match topics beginning with '$'
+        if (node->kind != SEGMENT_LITERAL && first_level && level[0] == '$')
+        {
+            continue;
+        }
+
+        if (node->kind == SEGMENT_HASH)
+        {
+            deliver_routes(child, msg, delivered);
+            continue;
+        }
+
+        if (node->kind == SEGMENT_LITERAL)
+        {
+            if (!hashed)
+            {
+                hash = segment_hash(level, length);
+                hashed = true;
+            }
+            if (node->hash != hash || node->length != length || memcmp(node->segment, level, length) != 0)
+            {
+                continue;
+            }
+        }
+
+        if (end == NULL)
+        {
+            deliver_routes(child, msg, delivered);
+
+            // "a/#" also matches "a"
+            for (int grandchild = node->first_child; grandchild != NODE_NONE;
+                 grandchild = nodes[grandchild].next_sibling)
+            {
+                if (nodes[grandchild].kind == SEGMENT_HASH)
+                {
+                    deliver_routes(grandchild, msg, delivered);
+                }
+            }
+        }
+        else
+        {
+            trie_match(child, end + 1, false, msg, delivered);
+        }
+    }
+}
+
+int ocre_msg_route_add(const char *filter, ocre_msg_handler_t handler, void *user_ctx)
+{
+    if (filter == NULL || handler == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    size_t length = strlen(filter);
+    if (length == 0 || length >= OCRE_MAX_TOPIC_LEN)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    int prefix_len = filter_validate(filter, length);
+    if (prefix_len < 0)
+    {
+        OCRE_LOG_ERR("Invalid topic filter: %s\n", filter);
+        return OCRE_ERROR_INVALID;
+    }
+
+    route_pool_init();
+
+    router_route_t *route;
+    if (ocre_pool_alloc(&route_pool, (void **)&route) != OCRE_SUCCESS)
+    {
+        OCRE_LOG_ERR("No free route for %s\n", filter);
+        return OCRE_ERROR_NO_MEMORY;
+    }
+    int route_id = ocre_pool_index(&route_pool, route);
+
+    if (node_count == 0)
+    {
+        trie_reset();
+    }
+
+    memcpy(route->filter, filter, length + 1);
+    route->prefix_len = (uint16_t)prefix_len;
+    route->handler = handler;
+    route->user_ctx = user_ctx;
+
+    int ret = host_subscribe(route);
+    if (ret == OCRE_SUCCESS)
+    {
+        route->used = true;
+        ret = trie_insert(route_id);
+        if (ret != OCRE_SUCCESS)
+        {
+            route->used = false;
+            trie_rebuild();
+        }
+    }
+
+    if (ret != OCRE_SUCCESS)
+    {
+        ocre_pool_free(&route_pool, route);
+        OCRE_LOG_ERR("Failed to add route for %s (%d)\n", filter, ret);
+        return ret;
+    }
+
+    OCRE_LOG_INF("Route %d added for %s\n", route_id, filter);
+    return route_id;
+}
+
+int ocre_msg_route_remove(int route_id)
+{
+    if (route_id < 0 || route_id >= CONFIG_OCRE_MSG_ROUTER_MAX_ROUTES || !routes[route_id].used)
+    {
+        return OCRE_ERROR_NOT_FOUND;
+    }
+
+    // The runtime subscription stays in place; unmatched messages are simply not routed
+    routes[route_id].used = false;
+    trie_rebuild();
+    ocre_pool_free(&route_pool, &routes[route_id]);
+    OCRE_LOG_INF("Route %d removed\n", route_id);
+    return OCRE_SUCCESS;
+}
+
+int ocre_msg_route_dispatch(const ocre_msg_t *msg)
+{
+    if (msg == NULL || msg->topic == NULL || node_count == 0)
+    {
+        return 0;
+    }
+
+    int delivered = 0;
+    trie_match(ROOT_NODE, msg->topic, true, msg, &delivered);
+    return delivered;
+}
+
+int ocre_msg_route_stats(ocre_pool_stats_t *stats)
+{
+    route_pool_init();
+    return ocre_pool_get_stats(&route_pool, stats);
+}
+
+// Loaned deliveries are released once every route has returned, so handlers never release them themselves
+OCRE_EXPORT("ocre_msg_router") void ocre_msg_router(ocre_msg_t *msg)
+{
+    if (msg == NULL || msg->topic == NULL)
+    {
+        return;
+    }
+
+    if (ocre_msg_route_dispatch(msg) == 0)
+    {
+        OCRE_LOG_DBG("No route for topic %s\n", msg->topic);
+    }
+
+    // As ocre_msg_release(); only loaned deliveries are known to the runtime
+    int ret = ocre_release_message(msg->mid);
+    if (ret != OCRE_SUCCESS && ret != OCRE_ERROR_NOT_FOUND)
+    {
+        OCRE_LOG_WRN("Failed to release message %u (%d)\n", (unsigned)msg->mid, ret);
+    }
+}
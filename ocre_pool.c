@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include <string.h>
+
+int ocre_pool_init(ocre_pool_t *pool, void *storage, size_t storage_size, size_t block_size)
+{
+    if (pool == NULL || storage == NULL || block_size == 0 || block_size % sizeof(void *) != 0 ||
+        block_size > UINT32_MAX || storage_size < block_size)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    if (storage_size / block_size > CONFIG_OCRE_POOL_MAX_BLOCKS)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    memset(pool, 0, sizeof(*pool));
+    pool->storage = storage;
+    pool->block_size = (uint32_t)block_size;
+    pool->block_count = (uint32_t)(storage_size / block_size);
+
+    // Thread the free list through the blocks, lowest address first
+    for (uint32_t i = pool->block_count; i > 0; i--)
+    {
+        void *block = pool->storage + (size_t)(i - 1) * block_size;
+        *(void **)block = pool->free_list;
+        pool->free_list = block;
+    }
+    return OCRE_SUCCESS;
+}
+
+int ocre_pool_alloc(ocre_pool_t *pool, void **block)
+{
+    if (pool == NULL || block == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    if (pool->free_list == NULL)
+    {
+        pool->failures++;
+        *block = NULL;
+        return OCRE_ERROR_NO_MEMORY;
+    }
+
+    *block = pool->free_list;
+    pool->free_list = *(void **)pool->free_list;
+
+    uint32_t index = (uint32_t)((uint8_t *)*block - pool->storage) / pool->block_size;
+    pool->allocated[index / 32] |= 1u << (index % 32);
+    if (++pool->in_use > pool->high_water)
+    {
+        pool->high_water = pool->in_use;
+    }
+    return OCRE_SUCCESS;
+}
+
+int ocre_pool_index(const ocre_pool_t *pool, const void *block)
+{
+    if (pool == NULL || block == NULL || (const uint8_t *)block < pool->storage)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    size_t offset = (size_t)((const uint8_t *)block - pool->storage);
+    if (offset % pool->block_size != 0 || offset / pool->block_size >= pool->block_count)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    return (int)(offset / pool->block_size);
+}
+
+int ocre_pool_free(ocre_pool_t *pool, void *block)
+{
+    int index = ocre_pool_index(pool, block);
+    if (index < 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    // A block already on the free list must not be linked in a second time
+    uint32_t bit = 1u << (index % 32);
+    if ((pool->allocated[index / 32] & bit) == 0)
+    {
+        OCRE_LOG_ERR("Pool block %d freed while not allocated\n", index);
+        return OCRE_ERROR_INVALID;
+    }
+    pool->allocated[index / 32] &= ~bit;
+
+    *(void **)block = pool->free_list;
+    pool->free_list = block;
+    pool->in_use--;
+    return OCRE_SUCCESS;
+}
+
+int ocre_pool_get_stats(const ocre_pool_t *pool, ocre_pool_stats_t *stats)
+{
+    if (pool == NULL || stats == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    stats->block_size = pool->block_size;
+    stats->block_count = pool->block_count;
+    stats->in_use = pool->in_use;
+    stats->high_water = pool->high_water;
+    stats->failures = pool->failures;
+    return OCRE_SUCCESS;
+}
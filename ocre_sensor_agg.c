@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include <string.h>
+
+#define AGG_PAYLOAD_SIZE 96 // Map of all statistics, "n" and "t"
+
+int ocre_sensor_agg_init(ocre_sensor_agg_t *agg, const ocre_sensor_agg_config_t *config, const char *topic)
+{
+    if (agg == NULL || config == NULL || config->window == 0 || config->deadband < 0 ||
+        (config->stats & ~OCRE_SENSOR_AGG_ALL) != 0 || (topic && strlen(topic) >= OCRE_MAX_TOPIC_LEN))
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    if (config->window_type == OCRE_SENSOR_AGG_SLIDING)
+    {
+        if (config->window > CONFIG_OCRE_SENSOR_AGG_WINDOW_MAX || config->step == 0 || config->step > config->window)
+        {
+            return OCRE_ERROR_INVALID;
+        }
+    }
+    else if (config->window_type != OCRE_SENSOR_AGG_TUMBLING)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    memset(agg, 0, sizeof(*agg));
+    agg->config = *config;
+    strcpy(agg->topic, topic ? topic : "");
+    return OCRE_SUCCESS;
+}
+
+void ocre_sensor_agg_reset(ocre_sensor_agg_t *agg)
+{
+    if (agg)
+    {
+        agg->skip = 0;
+        agg->count = 0;
+        agg->since_result = 0;
+        agg->head = 0;
+        agg->has_reference = false;
+    }
+}
+
+// Newton's method, so the SDK does not need libm
+static double agg_sqrt(double x)
+{
+    if (x <= 0)
+    {
+        return 0;
+    }
+
+    double r = x > 1 ? x / 2 : 1;
+    for (int i = 0; i < 64; i++)
+    {
+        double next = (r + x / r) / 2;
+        if (next >= r)
+        {
+            break;
+        }
+        r = next;
+    }
+    return r;
+}
+
+static ocre_sensor_value_t agg_abs(ocre_sensor_value_t value)
+{
+    return value < 0 ? -value : value;
+}
+
+static bool agg_sliding(const ocre_sensor_agg_t *agg)
+{
+    return agg->config.window_type == OCRE_SENSOR_AGG_SLIDING;
+}
+
+// Compute the statistics of the current window into agg->result
+static void agg_compute(ocre_sensor_agg_t *agg)
+{
+    ocre_sensor_agg_result_t *result = &agg->result;
+
+    if (agg_sliding(agg))
+    {
+        uint32_t first =
+            (agg->head + CONFIG_OCRE_SENSOR_AGG_WINDOW_MAX - agg->count) % CONFIG_OCRE_SENSOR_AGG_WINDOW_MAX;
+        agg->min = agg->values[first];
+        agg->max = agg->values[first];
+        agg->sum = 0;
+        agg->sum_sq = 0;
+        agg->start_ns = agg->timestamps[first];
+        for (uint32_t i = 0; i < agg->count; i++)
+        {
+            ocre_sensor_value_t value = agg->values[(first + i) % CONFIG_OCRE_SENSOR_AGG_WINDOW_MAX];
+            agg->min = value < agg->min ? value : agg->min;
+            agg->max = value > agg->max ? value : agg->max;
+            agg->sum += value;
+            agg->sum_sq += (double)value * (double)value;
+        }
+    }
+
+    result->min = agg->min;
+    result->max = agg->max;
+    result->mean = agg->sum / (int64_t)agg->count;
+    result->rms = (ocre_sensor_value_t)(agg_sqrt(agg->sum_sq / agg->count) + 0.5);
+    result->count = agg->count;
+    result->start_ns = agg->start_ns;
+    result->end_ns = agg->end_ns;
+}
+
+static int agg_publish(const ocre_sensor_agg_t *agg)
+{
+    static const struct
+    {
+        uint32_t stat;
+        const char *key;
+        size_t offset;
+    } fields[] = {
+        {OCRE_SENSOR_AGG_MIN, "min", offsetof(ocre_sensor_agg_result_t, min)},
+        {OCRE_SENSOR_AGG_MAX, "max", offsetof(ocre_sensor_agg_result_t, max)},
+        {OCRE_SENSOR_AGG_MEAN, "mean", offsetof(ocre_sensor_agg_result_t, mean)},
+        {OCRE_SENSOR_AGG_RMS, "rms", offsetof(ocre_sensor_agg_result_t, rms)},
+    };
+    uint8_t payload[AGG_PAYLOAD_SIZE];
+    ocre_cbor_writer_t writer;
+
+    ocre_cbor_writer_init(&writer, payload, sizeof(payload));
+    ocre_cbor_put_map(&writer, (size_t)__builtin_popcount(agg->config.stats) + 2);
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+    {
+        if (agg->config.stats & fields[i].stat)
+        {
+            ocre_sensor_value_t value;
+            memcpy(&value, (const uint8_t *)&agg->result + fields[i].offset, sizeof(value));
+            ocre_cbor_put_text(&writer, fields[i].key);
+            ocre_cbor_put_float(&writer, (double)value / OCRE_SENSOR_VALUE_SCALE);
+        }
+    }
+    ocre_cbor_put_text(&writer, "n");
+    ocre_cbor_put_uint(&writer, agg->result.count);
+    ocre_cbor_put_text(&writer, "t");
+    ocre_cbor_put_uint(&writer, agg->result.end_ns);
+
+    return ocre_cbor_publish((char *)agg->topic, &writer);
+}
+
+// Close the current window; a tumbling window starts over and a sliding window keeps its samples. Both the
+// closing and the early deadband checks measure against the sample last emitted, not the lagging window mean
+static int agg_emit(ocre_sensor_agg_t *agg, bool force)
+{
+    agg_compute(agg);
+    agg->since_result = 0;
+    if (!agg_sliding(agg))
+    {
+        agg->count = 0;
+    }
+
+    if (!force && agg->config.deadband > 0 && agg->has_reference &&
+        agg_abs(agg->last - agg->reference) <= agg->config.deadband)
+    {
+        agg->suppressed++;
+        return 0;
+    }
+
+    agg->has_reference = true;
+    agg->reference = agg->last;
+    agg->emitted++;
+
+    if (agg->topic[0] != '\0')
+    {
+        int ret = agg_publish(agg);
+        if (ret != OCRE_SUCCESS)
+        {
+            OCRE_LOG_WRN("Failed to publish aggregate on %s (%d)\n", agg->topic, ret);
+            return ret;
+        }
+    }
+    return 1;
+}
+
+int ocre_sensor_agg_add(ocre_sensor_agg_t *agg, ocre_sensor_value_t value, uint64_t timestamp_ns)
+{
+    if (agg == NULL || agg->config.window == 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    if (agg->skip > 0)
+    {
+        agg->skip--;
+        return 0;
+    }
+    agg->skip = agg->config.decimation > 1 ? agg->config.decimation - 1 : 0;
+
+    if (agg_sliding(agg))
+    {
+        agg->values[agg->head] = value;
+        agg->timestamps[agg->head] = timestamp_ns;
+        agg->head = (agg->head + 1) % CONFIG_OCRE_SENSOR_AGG_WINDOW_MAX;
+        if (agg->count < agg->config.window)
+        {
+            agg->count++;
+        }
+        agg->since_result++;
+    }
+    else
+    {
+        if (agg->count == 0)
+        {
+            agg->min = value;
+            agg->max = value;
+            agg->sum = 0;
+            agg->sum_sq = 0;
+            agg->start_ns = timestamp_ns;
+        }
+        agg->min = value < agg->min ? value : agg->min;
+        agg->max = value > agg->max ? value : agg->max;
+        agg->sum += value;
+        agg->sum_sq += (double)value * (double)value;
+        agg->count++;
+    }
+    agg->end_ns = timestamp_ns;
+    agg->last = value;
+
+    // A step beyond the deadband is reported without waiting for the window to close
+    if (agg->config.deadband > 0 && agg->has_reference && agg_abs(value - agg->reference) > agg->config.deadband)
+    {
+        return agg_emit(agg, true);
+    }
+
+    bool closed = agg_sliding(agg) ? agg->count == agg->config.window && agg->since_result >= agg->config.step
+                                   : agg->count >= agg->config.window;
+    return closed ? agg_emit(agg, false) : 0;
+}
+
+int ocre_sensor_agg_sample(ocre_sensor_agg_t *agg, int sensor_id, int channel_type)
+{
+    ocre_sensor_value_t value;
+    uint64_t timestamp_ns;
+
+    int ret = ocre_sensors_read_multi(sensor_id, &channel_type, &value, 1, &timestamp_ns);
+    if (ret < 0)
+    {
+        return ret;
+    }
+    return ocre_sensor_agg_add(agg, value, timestamp_ns);
+}
+
+int ocre_sensor_agg_flush(ocre_sensor_agg_t *agg)
+{
+    if (agg == NULL || agg->config.window == 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    return agg->count > 0 ? agg_emit(agg, true) : 0;
+}
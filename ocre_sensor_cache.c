@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include <string.h>
+
+// Runtime functions wrapped by the SDK
+OCRE_IMPORT("ocre_sensors_discover") int ocre_host_sensors_discover(void);
+OCRE_IMPORT("ocre_sensors_get_handle_by_name") int ocre_host_sensors_get_handle_by_name(const char *sensor_name);
+
+typedef struct
+{
+    bool valid;
+    bool opened;
+    uint32_t hash;
+    int handle;
+    int sensor_id;                // Runtime ID whose handle is @c handle
+    int channel_count;            // Negative until queried
+    uint32_t channel_types_known;  // Bit per cached entry of channel_types
+    int channel_types[CONFIG_OCRE_SENSOR_CACHE_MAX_CHANNELS];
+    char name[CONFIG_MAX_SENSOR_NAME_LENGTH + 1];
+} sensor_cache_entry_t;
+
+_Static_assert(CONFIG_OCRE_SENSOR_CACHE_MAX_CHANNELS <= 32, "channel_types_known holds at most 32 channels");
+
+static sensor_cache_entry_t sensor_cache[CONFIG_OCRE_SENSOR_CACHE_SIZE];
+static int sensor_cache_next = 0; // Round-robin replacement
+static int sensor_count = -1;     // Sensors found by the last discovery, negative until discovered
+
+static uint32_t name_hash(const char *name, size_t *length)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    size_t i = 0;
+    for (; name[i] != '\0'; i++)
+    {
+        hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+    }
+    *length = i;
+    return hash;
+}
+
+// Map a handle back to its sensor ID; the runtime numbers discovered sensors 0 .. count - 1
+static int sensor_id_for_handle(int handle)
+{
+    if (sensor_count < 0)
+    {
+        int count = ocre_host_sensors_discover();
+        if (count < 0)
+        {
+            return count;
+        }
+        sensor_count = count;
+    }
+
+    for (int id = 0; id < sensor_count; id++)
+    {
+        if (ocre_sensors_get_handle(id) == handle)
+        {
+            return id;
+        }
+    }
+    return OCRE_ERROR_NOT_FOUND;
+}
+
+// Find or resolve a sensor name; returns NULL and sets *error if the runtime cannot resolve it
+static sensor_cache_entry_t *sensor_cache_lookup(const char *sensor_name, int *error)
+{
+    if (sensor_name == NULL)
+    {
+        *error = OCRE_ERROR_INVALID;
+        return NULL;
+    }
+
+    size_t length;
+    uint32_t hash = name_hash(sensor_name, &length);
+    if (length > CONFIG_MAX_SENSOR_NAME_LENGTH)
+    {
+        *error = OCRE_ERROR_INVALID;
+        return NULL;
+    }
+
+    for (int i = 0; i < CONFIG_OCRE_SENSOR_CACHE_SIZE; i++)
+    {
+        sensor_cache_entry_t *entry = &sensor_cache[i];
+        if (entry->valid && entry->hash == hash && strcmp(entry->name, sensor_name) == 0)
+        {
+            return entry;
+        }
+    }
+
+    int handle = ocre_host_sensors_get_handle_by_name(sensor_name);
+    if (handle < 0)
+    {
+        *error = handle;
+        return NULL;
+    }
+
+    int sensor_id = sensor_id_for_handle(handle);
+    if (sensor_id < 0)
+    {
+        *error = sensor_id;
+        return NULL;
+    }
+
+    sensor_cache_entry_t *entry = &sensor_cache[sensor_cache_next];
+    sensor_cache_next = (sensor_cache_next + 1) % CONFIG_OCRE_SENSOR_CACHE_SIZE;
+
+    memset(entry, 0, sizeof(*entry));
+    entry->valid = true;
+    entry->hash = hash;
+    entry->handle = handle;
+    entry->sensor_id = sensor_id;
+    entry->channel_count = -1;
+    memcpy(entry->name, sensor_name, length + 1);
+    return entry;
+}
+
+int ocre_sensors_discover(void)
+{
+    int ret = ocre_host_sensors_discover();
+
+    // Handles and IDs may have changed
+    memset(sensor_cache, 0, sizeof(sensor_cache));
+    sensor_cache_next = 0;
+    sensor_count = ret;
+    return ret;
+}
+
+int ocre_sensors_get_handle_by_name(const char *sensor_name)
+{
+    int error;
+    sensor_cache_entry_t *entry = sensor_cache_lookup(sensor_name, &error);
+    return entry ? entry->handle : error;
+}
+
+int ocre_sensors_open_by_name(const char *sensor_name)
+{
+    int error;
+    sensor_cache_entry_t *entry = sensor_cache_lookup(sensor_name, &error);
+    if (entry == NULL)
+    {
+        return error;
+    }
+
+    if (entry->opened)
+    {
+        return OCRE_SUCCESS;
+    }
+
+    int ret = ocre_sensors_open(entry->handle);
+    if (ret == OCRE_SUCCESS)
+    {
+        entry->opened = true;
+    }
+    return ret;
+}
+
+int ocre_sensors_get_channel_count_by_name(const char *sensor_name)
+{
+    int error;
+    sensor_cache_entry_t *entry = sensor_cache_lookup(sensor_name, &error);
+    if (entry == NULL)
+    {
+        return error;
+    }
+
+    if (entry->channel_count < 0)
+    {
+        int count = ocre_sensors_get_channel_count(entry->sensor_id);
+        if (count < 0)
+        {
+            return count;
+        }
+        entry->channel_count = count;
+    }
+
+    return entry->channel_count;
+}
+
+int ocre_sensors_get_channel_type_by_name(const char *sensor_name, ocre_sensor_handle_t channel_index)
+{
+    int error;
+    sensor_cache_entry_t *entry = sensor_cache_lookup(sensor_name, &error);
+    if (entry == NULL)
+    {
+        return error;
+    }
+
+    if (channel_index < 0 || channel_index >= CONFIG_OCRE_SENSOR_CACHE_MAX_CHANNELS)
+    {
+        return ocre_sensors_get_channel_type(entry->sensor_id, channel_index);
+    }
+
+    uint32_t bit = 1u << channel_index;
+    if ((entry->channel_types_known & bit) == 0)
+    {
+        int type = ocre_sensors_get_channel_type(entry->sensor_id, channel_index);
+        if (type < 0)
+        {
+            return type;
+        }
+        entry->channel_types[channel_index] = type;
+        entry->channel_types_known |= bit;
+    }
+
+    return entry->channel_types[channel_index];
+}
+
+int ocre_sensors_read_by_name(const char *sensor_name, int channel_type)
+{
+    int error;
+    sensor_cache_entry_t *entry = sensor_cache_lookup(sensor_name, &error);
+    return entry ? ocre_sensors_read(entry->sensor_id, channel_type) : error;
+}
+
+int ocre_sensors_read_multi_by_name(const char *sensor_name, const int *channel_types, ocre_sensor_value_t *values,
+                                    int count, uint64_t *timestamp_ns)
+{
+    int error;
+    sensor_cache_entry_t *entry = sensor_cache_lookup(sensor_name, &error);
+    return entry ? ocre_sensors_read_multi(entry->sensor_id, channel_types, values, count, timestamp_ns) : error;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include <string.h>
+
+_Static_assert((CONFIG_OCRE_SENSOR_STREAM_DEPTH & (CONFIG_OCRE_SENSOR_STREAM_DEPTH - 1)) == 0,
+               "CONFIG_OCRE_SENSOR_STREAM_DEPTH must be a power of two");
+
+int ocre_sensor_stream_open(ocre_sensor_stream_t *stream, int sensor_id, const int *channel_types,
+                            int channel_count, int rate_hz, int notify_every)
+{
+    if (stream == NULL || channel_types == NULL || channel_count <= 0 ||
+        channel_count > CONFIG_OCRE_SENSOR_STREAM_MAX_CHANNELS || rate_hz <= 0 || notify_every <= 0 ||
+        notify_every > CONFIG_OCRE_SENSOR_STREAM_DEPTH)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    memset(stream, 0, sizeof(*stream));
+    stream->version = OCRE_SENSOR_STREAM_VERSION;
+    stream->capacity = CONFIG_OCRE_SENSOR_STREAM_DEPTH;
+    stream->channel_count = (uint32_t)channel_count;
+    stream->sensor_id = sensor_id;
+
+    int ret = ocre_sensors_stream_start(sensor_id, channel_types, channel_count, rate_hz, notify_every, stream);
+    if (ret != OCRE_SUCCESS)
+    {
+        OCRE_LOG_ERR("Failed to start stream for sensor %d (%d)\n", sensor_id, ret);
+        return ret;
+    }
+
+    OCRE_LOG_INF("Streaming sensor %d: %d channels at %d Hz\n", sensor_id, channel_count, rate_hz);
+    return OCRE_SUCCESS;
+}
+
+int ocre_sensor_stream_close(ocre_sensor_stream_t *stream)
+{
+    if (stream == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    return ocre_sensors_stream_stop(stream->sensor_id);
+}
+
+int ocre_sensor_stream_available(const ocre_sensor_stream_t *stream)
+{
+    if (stream == NULL)
+    {
+        return 0;
+    }
+
+    uint32_t head = __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE);
+    return (int)(head - stream->tail);
+}
+
+int ocre_sensor_stream_read(ocre_sensor_stream_t *stream, ocre_sensor_sample_t *samples, int max_samples)
+{
+    if (stream == NULL || samples == NULL || max_samples < 0)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    uint32_t tail = stream->tail;
+    uint32_t head = __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE);
+    int count = 0;
+
+    while (tail != head && count < max_samples)
+    {
+        samples[count++] = stream->samples[tail & (CONFIG_OCRE_SENSOR_STREAM_DEPTH - 1)];
+        tail++;
+    }
+
+    __atomic_store_n(&stream->tail, tail, __ATOMIC_RELEASE);
+    return count;
+}
@@ -0,0 +1,408 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include <string.h>
+
+#define WHEEL_LEVELS 4
+#define WHEEL_SLOT_BITS 6
+#define WHEEL_SLOTS (1u << WHEEL_SLOT_BITS)
+#define WHEEL_SLOT_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_RANGE (1u << (WHEEL_LEVELS * WHEEL_SLOT_BITS)) // Ticks covered by the wheel
+
+#define LEVEL_SHIFT(level) ((level) * WHEEL_SLOT_BITS)
+
+// Wrap-safe tick comparison
+#define TICK_BEFORE(a, b) ((int32_t)((a) - (b)) < 0)
+
+typedef struct
+{
+    bool initialized;
+    bool advancing;      // Expiry callbacks are running; defer host reprogramming
+    bool host_armed;     // Runtime timer is running
+    bool running;        // host_start and host_start_ms map wheel ticks to clock time
+    uint32_t now;        // Current wheel tick
+    uint32_t host_deadline;
+    uint32_t host_start;     // Wheel tick at host_start_ms
+    uint64_t host_start_ms;  // Clock time the host timer deadlines are measured from
+    uint64_t occupied[WHEEL_LEVELS]; // Bit per non-empty slot
+    ocre_soft_timer_t *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+} timer_wheel_t;
+
+static timer_wheel_t wheel;
+
+static void wheel_host_expired(void);
+
+static inline uint64_t rotate_right(uint64_t bits, unsigned count)
+{
+    count &= 63;
+    return count ? (bits >> count) | (bits << (64 - count)) : bits;
+}
+
+static inline uint32_t ms_to_ticks(uint32_t ms)
+{
+    return (ms + CONFIG_OCRE_SOFT_TIMER_TICK_MS - 1) / CONFIG_OCRE_SOFT_TIMER_TICK_MS;
+}
+
+static int wheel_init(void)
+{
+    if (wheel.initialized)
+    {
+        return OCRE_SUCCESS;
+    }
+
+    int ret = ocre_timer_create(CONFIG_OCRE_SOFT_TIMER_HOST_ID);
+    if (ret == OCRE_SUCCESS)
+    {
+        ret = ocre_register_timer_callback(CONFIG_OCRE_SOFT_TIMER_HOST_ID, wheel_host_expired);
+    }
+    if (ret != OCRE_SUCCESS)
+    {
+        OCRE_LOG_ERR("Failed to set up soft timer host timer %d (%d)\n", CONFIG_OCRE_SOFT_TIMER_HOST_ID, ret);
+        return ret;
+    }
+
+    wheel.initialized = true;
+    return OCRE_SUCCESS;
+}
+
+static void wheel_insert(ocre_soft_timer_t *timer)
+{
+    uint32_t delta = timer->expires - wheel.now;
+
+    // Timers beyond the wheel's range park in the top level and are re-inserted on cascade
+    uint32_t placement = delta < WHEEL_RANGE ? timer->expires : wheel.now + WHEEL_RANGE - 1;
+    if (delta >= WHEEL_RANGE)
+    {
+        delta = WHEEL_RANGE - 1;
+    }
+
+    int level = 0;
+    while (level < WHEEL_LEVELS - 1 && delta >= (1u << LEVEL_SHIFT(level + 1)))
+    {
+        level++;
+    }
+
+    uint32_t slot = (placement >> LEVEL_SHIFT(level)) & WHEEL_SLOT_MASK;
+    ocre_soft_timer_t **head = &wheel.slots[level][slot];
+
+    timer->level = (uint8_t)level;
+    timer->slot = (uint8_t)slot;
+    timer->next = *head;
+    if (*head)
+    {
+        (*head)->pprev = &timer->next;
+    }
+    timer->pprev = head;
+    *head = timer;
+    wheel.occupied[level] |= 1ull << slot;
+}
+
+static void wheel_remove(ocre_soft_timer_t *timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next)
+    {
+        timer->next->pprev = timer->pprev;
+    }
+    if (wheel.slots[timer->level][timer->slot] == NULL)
+    {
+        wheel.occupied[timer->level] &= ~(1ull << timer->slot);
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+// Next tick at which a timer expires or a higher-level slot must cascade; false if the wheel is empty
+static bool wheel_next_event(uint32_t *tick)
+{
+    bool found = false;
+    uint32_t best = 0;
+
+    for (int level = 0; level < WHEEL_LEVELS; level++)
+    {
+        if (wheel.occupied[level] == 0)
+        {
+            continue;
+        }
+
+        uint32_t base = wheel.now >> LEVEL_SHIFT(level);
+        uint64_t rotated = rotate_right(wheel.occupied[level], base & WHEEL_SLOT_MASK);
+        uint32_t offset;
+
+        if (level == 0 && (rotated & 1))
+        {
+            offset = 0; // Due now
+        }
+        else if (rotated >> 1)
+        {
+            offset = (uint32_t)__builtin_ctzll(rotated >> 1) + 1;
+        }
+        else
+        {
+            offset = WHEEL_SLOTS; // Only the current slot, which comes round again after a full turn
+        }
+
+        uint32_t candidate = (base + offset) << LEVEL_SHIFT(level);
+        if (!found || TICK_BEFORE(candidate, best))
+        {
+            best = candidate;
+            found = true;
+        }
+    }
+
+    *tick = best;
+    return found;
+}
+
+// Move the timers of a higher-level slot down the wheel
+static void wheel_cascade(int level, uint32_t slot)
+{
+    ocre_soft_timer_t *timer = wheel.slots[level][slot];
+    wheel.slots[level][slot] = NULL;
+    wheel.occupied[level] &= ~(1ull << slot);
+
+    while (timer)
+    {
+        ocre_soft_timer_t *next = timer->next;
+        timer->next = NULL;
+        timer->pprev = NULL;
+        wheel_insert(timer);
+        timer = next;
+    }
+}
+
+static void wheel_expire_current(void)
+{
+    uint32_t slot = wheel.now & WHEEL_SLOT_MASK;
+    ocre_soft_timer_t *timer;
+
+    // Unlink one timer at a time so callbacks may start or stop any timer
+    while ((timer = wheel.slots[0][slot]) != NULL)
+    {
+        wheel_remove(timer);
+
+        if (timer->period)
+        {
+            timer->expires += timer->period;
+            wheel_insert(timer);
+        }
+
+        timer->func(timer, timer->user_ctx);
+    }
+}
+
+// Advance the wheel to target, running expired timers on the way
+static void wheel_advance(uint32_t target)
+{
+    wheel.advancing = true;
+
+    while (TICK_BEFORE(wheel.now, target))
+    {
+        uint32_t next;
+        if (!wheel_next_event(&next) || TICK_BEFORE(target, next))
+        {
+            wheel.now = target;
+            break;
+        }
+
+        wheel.now = next;
+        for (int level = 1; level < WHEEL_LEVELS; level++)
+        {
+            if (wheel.now & ((1u << LEVEL_SHIFT(level)) - 1))
+            {
+                break;
+            }
+            wheel_cascade(level, (wheel.now >> LEVEL_SHIFT(level)) & WHEEL_SLOT_MASK);
+        }
+        wheel_expire_current();
+    }
+
+    wheel.advancing = false;
+}
+
+// Bring wheel.now up to date with the running host timer without expiring anything
+static void wheel_sync(void)
+{
+    if (!wheel.host_armed || wheel.advancing)
+    {
+        return;
+    }
+
+    uint32_t current;
+    if (ocre_clock_is_shared())
+    {
+        // Reading the shared clock avoids a runtime call per timer start
+        uint64_t elapsed_ms = ocre_clock_monotonic_ms() - wheel.host_start_ms;
+        current = wheel.host_start + (uint32_t)(elapsed_ms / CONFIG_OCRE_SOFT_TIMER_TICK_MS);
+    }
+    else
+    {
+        int remaining_ms = ocre_timer_get_remaining(CONFIG_OCRE_SOFT_TIMER_HOST_ID);
+        if (remaining_ms < 0)
+        {
+            return;
+        }
+        current = wheel.host_deadline - ms_to_ticks((uint32_t)remaining_ms);
+    }
+
+    uint32_t limit = wheel.host_deadline - 1; // Expiries are left to the host timer event
+    if (TICK_BEFORE(limit, current))
+    {
+        current = limit;
+    }
+    if (TICK_BEFORE(wheel.now, current))
+    {
+        wheel_advance(current);
+    }
+}
+
+// Point the host timer at the next wheel event, or stop it if the wheel is empty
+static void wheel_reprogram(void)
+{
+    uint32_t next;
+
+    if (!wheel_next_event(&next))
+    {
+        if (wheel.host_armed)
+        {
+            ocre_timer_stop(CONFIG_OCRE_SOFT_TIMER_HOST_ID);
+            wheel.host_armed = false;
+        }
+        wheel.running = false;
+        return;
+    }
+
+    if (wheel.host_armed && next == wheel.host_deadline)
+    {
+        return;
+    }
+
+    if (!TICK_BEFORE(wheel.now, next))
+    {
+        next = wheel.now + 1;
+    }
+
+    // Deadlines are measured from a fixed clock time while the wheel runs, so time spent in callbacks and event
+    // handling does not accumulate
+    uint64_t now_ms = ocre_clock_monotonic_ms();
+    if (!wheel.running)
+    {
+        wheel.running = true;
+        wheel.host_start = wheel.now;
+        wheel.host_start_ms = now_ms;
+    }
+    uint64_t deadline_ms = wheel.host_start_ms + (uint64_t)(next - wheel.host_start) * CONFIG_OCRE_SOFT_TIMER_TICK_MS;
+    uint64_t timeout_ms = deadline_ms > now_ms ? deadline_ms - now_ms : 1;
+
+    if (ocre_timer_start(CONFIG_OCRE_SOFT_TIMER_HOST_ID, (int)timeout_ms, 0) != OCRE_SUCCESS)
+    {
+        OCRE_LOG_ERR("Failed to start soft timer host timer\n");
+        wheel.host_armed = false;
+        wheel.running = false;
+        return;
+    }
+
+    wheel.host_armed = true;
+    wheel.host_deadline = next;
+}
+
+static void wheel_host_expired(void)
+{
+    // Ignore expiries queued before the host timer was stopped or re-armed
+    if (!wheel.host_armed || ocre_timer_get_remaining(CONFIG_OCRE_SOFT_TIMER_HOST_ID) > 0)
+    {
+        return;
+    }
+
+    // Catch up with the time spent before this event was handled, never stopping short of the deadline
+    uint64_t elapsed_ms = ocre_clock_monotonic_ms() - wheel.host_start_ms;
+    uint32_t current = wheel.host_start + (uint32_t)(elapsed_ms / CONFIG_OCRE_SOFT_TIMER_TICK_MS);
+    if (TICK_BEFORE(current, wheel.host_deadline))
+    {
+        current = wheel.host_deadline;
+    }
+
+    // Move the reference point up so tick differences stay small on a long-running wheel
+    wheel.host_start_ms += (uint64_t)(current - wheel.host_start) * CONFIG_OCRE_SOFT_TIMER_TICK_MS;
+    wheel.host_start = current;
+
+    wheel.host_armed = false;
+    wheel_advance(current);
+    wheel_reprogram();
+}
+
+void ocre_soft_timer_init(ocre_soft_timer_t *timer, ocre_soft_timer_func_t func, void *user_ctx)
+{
+    memset(timer, 0, sizeof(*timer));
+    timer->func = func;
+    timer->user_ctx = user_ctx;
+}
+
+int ocre_soft_timer_start(ocre_soft_timer_t *timer, uint32_t timeout_ms, uint32_t period_ms)
+{
+    if (timer == NULL || timer->func == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    int ret = wheel_init();
+    if (ret != OCRE_SUCCESS)
+    {
+        return ret;
+    }
+
+    if (timer->pprev)
+    {
+        wheel_remove(timer);
+    }
+
+    wheel_sync();
+
+    uint32_t ticks = ms_to_ticks(timeout_ms);
+    timer->expires = wheel.now + (ticks ? ticks : 1);
+    timer->period = ms_to_ticks(period_ms);
+    wheel_insert(timer);
+
+    // Only touch the host timer when this timer becomes the earliest deadline
+    if (!wheel.advancing && (!wheel.host_armed || TICK_BEFORE(timer->expires, wheel.host_deadline)))
+    {
+        wheel_reprogram();
+    }
+    return OCRE_SUCCESS;
+}
+
+int ocre_soft_timer_stop(ocre_soft_timer_t *timer)
+{
+    if (timer == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    // The host timer is left running; an early expiry simply reprograms it
+    if (timer->pprev)
+    {
+        wheel_remove(timer);
+    }
+    return OCRE_SUCCESS;
+}
+
+bool ocre_soft_timer_is_active(const ocre_soft_timer_t *timer)
+{
+    return timer != NULL && timer->pprev != NULL;
+}
+
+uint32_t ocre_soft_timer_remaining(const ocre_soft_timer_t *timer)
+{
+    if (!ocre_soft_timer_is_active(timer))
+    {
+        return 0;
+    }
+
+    wheel_sync();
+    if (!TICK_BEFORE(wheel.now, timer->expires))
+    {
+        return 0;
+    }
+    return (timer->expires - wheel.now) * CONFIG_OCRE_SOFT_TIMER_TICK_MS;
+}
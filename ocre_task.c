@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include <string.h>
+
+typedef enum
+{
+    TASK_IDLE,
+    TASK_READY,
+    TASK_RUNNING,
+    TASK_WAITING,
+    TASK_DONE, // Finished or stopped; unlinked on the next scheduler pass
+} task_status_t;
+
+static ocre_task_t *task_list = NULL;
+static bool delivering_message = false; // Routes cannot be removed while the router is matching
+
+static void task_release(ocre_task_t *task)
+{
+    ocre_soft_timer_stop(&task->timer);
+    if (task->route_id >= 0 && !delivering_message)
+    {
+        ocre_msg_route_remove(task->route_id);
+        task->route_id = -1;
+    }
+}
+
+static void task_resume(ocre_task_t *task)
+{
+    task->status = TASK_RUNNING;
+    int result = task->func(task);
+
+    if (task->status != TASK_RUNNING)
+    {
+        return; // Stopped itself or already waiting
+    }
+
+    if (result == OCRE_TASK_EXITED)
+    {
+        task->status = TASK_DONE;
+        task_release(task);
+    }
+    else
+    {
+        // Yielded, or returned OCRE_TASK_WAITING without awaiting anything
+        task->status = TASK_READY;
+    }
+}
+
+static void task_timer_expired(ocre_soft_timer_t *timer, void *user_ctx)
+{
+    ocre_task_t *task = user_ctx;
+    if (task->status == TASK_WAITING)
+    {
+        task->timed_out = task->wait_type != OCRE_TASK_WAIT_SLEEP;
+        task->status = TASK_READY;
+    }
+}
+
+// Message delivery resumes the task immediately; the message is only valid during delivery. The router releases
+// loaned deliveries afterwards, including the ones dropped here
+static void task_on_message(const ocre_msg_t *msg, void *user_ctx)
+{
+    ocre_task_t *task = user_ctx;
+    if (task->status != TASK_WAITING || task->wait_type != OCRE_TASK_WAIT_MESSAGE)
+    {
+        OCRE_LOG_DBG("Task not awaiting a message, dropping %s\n", msg->topic);
+        return;
+    }
+
+    ocre_soft_timer_stop(&task->timer);
+    task->msg = msg;
+
+    bool nested = delivering_message;
+    delivering_message = true;
+    task_resume(task);
+    delivering_message = nested;
+
+    if (task->msg == msg)
+    {
+        task->msg = NULL;
+    }
+}
+
+static bool task_linked(const ocre_task_t *task)
+{
+    for (ocre_task_t *t = task_list; t; t = t->next)
+    {
+        if (t == task)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int ocre_task_start(ocre_task_t *task, ocre_task_func_t func, void *user_ctx)
+{
+    if (task == NULL || func == NULL)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+
+    bool linked = task_linked(task);
+    if (linked && task->status != TASK_DONE)
+    {
+        return OCRE_ERROR_BUSY;
+    }
+
+    ocre_task_t *next = NULL;
+    if (linked)
+    {
+        // Restarting a stopped task that has not been unlinked yet
+        task_release(task);
+        next = task->next;
+    }
+
+    memset(task, 0, sizeof(*task));
+    task->func = func;
+    task->user_ctx = user_ctx;
+    task->route_id = -1;
+    task->wait_type = OCRE_TASK_WAIT_SLEEP;
+    task->status = TASK_READY;
+    ocre_soft_timer_init(&task->timer, task_timer_expired, task);
+
+    // New tasks go to the tail so a scheduler pass in progress keeps valid links
+    task->next = next;
+    if (!linked)
+    {
+        ocre_task_t **link = &task_list;
+        while (*link)
+        {
+            link = &(*link)->next;
+        }
+        *link = task;
+    }
+    return OCRE_SUCCESS;
+}
+
+int ocre_task_stop(ocre_task_t *task)
+{
+    if (task == NULL || !task_linked(task) || task->status == TASK_DONE)
+    {
+        return OCRE_ERROR_NOT_FOUND;
+    }
+
+    task->status = TASK_DONE;
+    task_release(task);
+    return OCRE_SUCCESS;
+}
+
+int ocre_task_subscribe(ocre_task_t *task, const char *filter)
+{
+    if (task == NULL || task->status == TASK_IDLE || task->status == TASK_DONE)
+    {
+        return OCRE_ERROR_INVALID;
+    }
+    if (task->route_id >= 0)
+    {
+        return OCRE_ERROR_BUSY;
+    }
+
+    int route_id = ocre_msg_route_add(filter, task_on_message, task);
+    if (route_id < 0)
+    {
+        return route_id;
+    }
+
+    task->route_id = route_id;
+    return OCRE_SUCCESS;
+}
+
+void ocre_task_wait(ocre_task_t *task, int type, int id, int port, uint32_t timeout_ms)
+{
+    task->wait_type = (int8_t)type;
+    task->wait_id = id;
+    task->wait_port = port;
+    task->event_state = 0;
+    task->timed_out = false;
+    task->status = TASK_WAITING;
+
+    // Events for resources without a registered callback still need the dispatcher
+    if (type >= 0 && type < OCRE_RESOURCE_TYPE_COUNT)
+    {
+        ocre_dispatcher_enable((ocre_resource_type_t)type);
+    }
+
+    if (type == OCRE_TASK_WAIT_MESSAGE && task->route_id < 0)
+    {
+        OCRE_LOG_WRN("Task awaits a message without a subscription\n");
+    }
+
+    if (timeout_ms > 0 || type == OCRE_TASK_WAIT_SLEEP)
+    {
+        if (ocre_soft_timer_start(&task->timer, timeout_ms, 0) != OCRE_SUCCESS)
+        {
+            OCRE_LOG_ERR("Failed to start task timer\n");
+            task->timed_out = type != OCRE_TASK_WAIT_SLEEP;
+            task->status = TASK_READY;
+        }
+    }
+}
+
+int ocre_task_notify(ocre_resource_type_t type, int id, int port, int state)
+{
+    int woken = 0;
+
+    for (ocre_task_t *task = task_list; task; task = task->next)
+    {
+        if (task->status == TASK_WAITING && task->wait_type == (int8_t)type && task->wait_id == id &&
+            (task->wait_port < 0 || task->wait_port == port))
+        {
+            ocre_soft_timer_stop(&task->timer);
+            task->event_state = state;
+            task->status = TASK_READY;
+            woken++;
+        }
+    }
+    return woken;
+}
+
+int ocre_task_run(void)
+{
+    int run = 0;
+    ocre_task_t **link = &task_list;
+
+    while (*link)
+    {
+        ocre_task_t *task = *link;
+
+        if (task->status == TASK_READY)
+        {
+            task_resume(task);
+            run++;
+        }
+
+        if (task->status == TASK_DONE)
+        {
+            task_release(task);
+            *link = task->next;
+            task->next = NULL;
+            task->status = TASK_IDLE;
+            continue;
+        }
+        link = &task->next;
+    }
+
+    return run;
+}
+
+bool ocre_task_ready(void)
+{
+    for (ocre_task_t *task = task_list; task; task = task->next)
+    {
+        if (task->status == TASK_READY || task->status == TASK_DONE)
+        {
+            return true;
+        }
+    }
+    return false;
+}
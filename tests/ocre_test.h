@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#ifndef OCRE_TEST_H
+#define OCRE_TEST_H
+
+#include <stdio.h>
+
+// Minimal checks for the native behavior tests; a test returns ocre_test_failures from main()
+static int ocre_test_failures = 0;
+
+#define OCRE_CHECK(cond)                                                                                              \
+    do                                                                                                                \
+    {                                                                                                                 \
+        if (!(cond))                                                                                                  \
+        {                                                                                                             \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);                                 \
+            ocre_test_failures++;                                                                                     \
+        }                                                                                                             \
+    } while (0)
+
+#define OCRE_CHECK_EQ(actual, expected)                                                                               \
+    do                                                                                                                \
+    {                                                                                                                 \
+        long long actual_ = (long long)(actual);                                                                      \
+        long long expected_ = (long long)(expected);                                                                  \
+        if (actual_ != expected_)                                                                                     \
+        {                                                                                                             \
+            fprintf(stderr, "%s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__, #actual, actual_, expected_);   \
+            ocre_test_failures++;                                                                                     \
+        }                                                                                                             \
+    } while (0)
+
+#endif
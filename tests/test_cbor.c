@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include "ocre_test.h"
+#include <math.h>
+#include <string.h>
+
+static void test_int_round_trip(void)
+{
+    static const struct
+    {
+        uint64_t value;
+        size_t encoded_len;
+    } uints[] = {
+        {0, 1},       {23, 1},         {24, 2},          {255, 2},           {256, 3},
+        {65535, 3},   {65536, 5},      {UINT32_MAX, 5},  {1ull << 32, 9},    {UINT64_MAX, 9},
+    };
+    static const int64_t ints[] = {-1, -24, -25, -256, -257, INT32_MIN, INT64_MIN, INT64_MAX};
+
+    for (size_t i = 0; i < sizeof(uints) / sizeof(uints[0]); i++)
+    {
+        uint8_t buf[16];
+        ocre_cbor_writer_t writer;
+        ocre_cbor_reader_t reader;
+        ocre_cbor_item_t item;
+
+        ocre_cbor_writer_init(&writer, buf, sizeof(buf));
+        OCRE_CHECK_EQ(ocre_cbor_put_uint(&writer, uints[i].value), OCRE_SUCCESS);
+        OCRE_CHECK_EQ(writer.len, uints[i].encoded_len);
+
+        ocre_cbor_reader_init(&reader, buf, writer.len);
+        OCRE_CHECK_EQ(ocre_cbor_next(&reader, &item), OCRE_SUCCESS);
+        OCRE_CHECK_EQ(item.type, OCRE_CBOR_UINT);
+        OCRE_CHECK(item.v.u == uints[i].value);
+        OCRE_CHECK_EQ(reader.pos, writer.len);
+    }
+
+    for (size_t i = 0; i < sizeof(ints) / sizeof(ints[0]); i++)
+    {
+        uint8_t buf[16];
+        ocre_cbor_writer_t writer;
+        ocre_cbor_reader_t reader;
+        int64_t value = 0;
+
+        ocre_cbor_writer_init(&writer, buf, sizeof(buf));
+        OCRE_CHECK_EQ(ocre_cbor_put_int(&writer, ints[i]), OCRE_SUCCESS);
+        ocre_cbor_reader_init(&reader, buf, writer.len);
+        OCRE_CHECK_EQ(ocre_cbor_get_int(&reader, &value), OCRE_SUCCESS);
+        OCRE_CHECK(value == ints[i]);
+    }
+}
+
+static void test_float_round_trip(void)
+{
+    static const struct
+    {
+        double value;
+        size_t encoded_len;
+    } floats[] = {
+        {0.5, 5},   {-2.25, 5}, {0.1, 9}, {1e300, 9}, {-1e300, 9}, {3.5e38, 9}, {INFINITY, 5}, {-INFINITY, 5},
+    };
+
+    for (size_t i = 0; i < sizeof(floats) / sizeof(floats[0]); i++)
+    {
+        uint8_t buf[16];
+        ocre_cbor_writer_t writer;
+        ocre_cbor_reader_t reader;
+        double value = 0;
+
+        ocre_cbor_writer_init(&writer, buf, sizeof(buf));
+        OCRE_CHECK_EQ(ocre_cbor_put_float(&writer, floats[i].value), OCRE_SUCCESS);
+        OCRE_CHECK_EQ(writer.len, floats[i].encoded_len);
+        ocre_cbor_reader_init(&reader, buf, writer.len);
+        OCRE_CHECK_EQ(ocre_cbor_get_float(&reader, &value), OCRE_SUCCESS);
+        OCRE_CHECK(value == floats[i].value);
+    }
+
+    uint8_t buf[16];
+    ocre_cbor_writer_t writer;
+    ocre_cbor_reader_t reader;
+    double value = 0;
+
+    ocre_cbor_writer_init(&writer, buf, sizeof(buf));
+    ocre_cbor_put_float(&writer, NAN);
+    OCRE_CHECK_EQ(writer.len, 3);
+    ocre_cbor_reader_init(&reader, buf, writer.len);
+    OCRE_CHECK_EQ(ocre_cbor_get_float(&reader, &value), OCRE_SUCCESS);
+    OCRE_CHECK(isnan(value));
+
+    // Half precision is decoded only
+    static const uint8_t half_one[] = {0xf9, 0x3c, 0x00};
+    ocre_cbor_reader_init(&reader, half_one, sizeof(half_one));
+    OCRE_CHECK_EQ(ocre_cbor_get_float(&reader, &value), OCRE_SUCCESS);
+    OCRE_CHECK(value == 1.0);
+}
+
+static void test_container_round_trip(void)
+{
+    uint8_t buf[64];
+    ocre_cbor_writer_t writer;
+    ocre_cbor_reader_t reader;
+    ocre_cbor_reader_t value;
+    ocre_cbor_item_t item;
+    const char *text;
+    size_t len;
+
+    ocre_cbor_writer_init(&writer, buf, sizeof(buf));
+    ocre_cbor_put_map(&writer, 3);
+    ocre_cbor_put_text(&writer, "a");
+    ocre_cbor_put_array(&writer, 2);
+    ocre_cbor_put_tag(&writer, 1);
+    ocre_cbor_put_uint(&writer, 1700000000);
+    ocre_cbor_put_bytes(&writer, "\x01\x02", 2);
+    ocre_cbor_put_text(&writer, "b");
+    ocre_cbor_put_text(&writer, "hello");
+    ocre_cbor_put_text(&writer, "c");
+    ocre_cbor_put_bool(&writer, true);
+    OCRE_CHECK_EQ(writer.error, OCRE_SUCCESS);
+
+    ocre_cbor_reader_init(&reader, buf, writer.len);
+    OCRE_CHECK_EQ(ocre_cbor_map_find(&reader, "b", &value), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_cbor_get_text(&value, &text, &len), OCRE_SUCCESS);
+    OCRE_CHECK(len == 5 && memcmp(text, "hello", 5) == 0);
+
+    OCRE_CHECK_EQ(ocre_cbor_map_find(&reader, "c", &value), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_cbor_next(&value, &item), OCRE_SUCCESS);
+    OCRE_CHECK(item.type == OCRE_CBOR_BOOL && item.v.b);
+
+    OCRE_CHECK_EQ(ocre_cbor_map_find(&reader, "missing", &value), OCRE_ERROR_NOT_FOUND);
+
+    // The whole map is one item
+    OCRE_CHECK_EQ(ocre_cbor_skip(&reader), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(reader.pos, writer.len);
+    OCRE_CHECK_EQ(ocre_cbor_skip(&reader), OCRE_ERROR_NOT_FOUND);
+}
+
+static void test_writer_overflow(void)
+{
+    uint8_t buf[4];
+    ocre_cbor_writer_t writer;
+
+    ocre_cbor_writer_init(&writer, buf, sizeof(buf));
+    OCRE_CHECK_EQ(ocre_cbor_put_text(&writer, "hello"), OCRE_ERROR_NO_MEMORY);
+
+    // Errors are sticky, even for items that would fit
+    OCRE_CHECK_EQ(ocre_cbor_put_uint(&writer, 1), OCRE_ERROR_NO_MEMORY);
+    OCRE_CHECK_EQ(ocre_cbor_publish("test", &writer), OCRE_ERROR_NO_MEMORY);
+}
+
+static int next_result(const uint8_t *buf, size_t size)
+{
+    ocre_cbor_reader_t reader;
+    ocre_cbor_item_t item;
+
+    ocre_cbor_reader_init(&reader, buf, size);
+    int ret = ocre_cbor_next(&reader, &item);
+    if (ret != OCRE_SUCCESS)
+    {
+        OCRE_CHECK_EQ(reader.pos, 0); // A failed read does not consume input
+    }
+    return ret;
+}
+
+static int skip_result(const uint8_t *buf, size_t size)
+{
+    ocre_cbor_reader_t reader;
+
+    ocre_cbor_reader_init(&reader, buf, size);
+    return ocre_cbor_skip(&reader);
+}
+
+static void test_malformed(void)
+{
+    // Truncated heads
+    static const uint8_t uint8_missing[] = {0x18};
+    static const uint8_t uint16_short[] = {0x19, 0x01};
+    static const uint8_t uint64_short[] = {0x1b, 0x01, 0x02, 0x03};
+    static const uint8_t double_short[] = {0xfb, 0x3f, 0xf0};
+    OCRE_CHECK_EQ(next_result(uint8_missing, sizeof(uint8_missing)), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(next_result(uint16_short, sizeof(uint16_short)), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(next_result(uint64_short, sizeof(uint64_short)), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(next_result(double_short, sizeof(double_short)), OCRE_ERROR_INVALID);
+
+    // Reserved additional information and indefinite lengths
+    static const uint8_t reserved[] = {0x1c};
+    static const uint8_t indefinite[] = {0x5f, 0x41, 0x00, 0xff};
+    OCRE_CHECK_EQ(next_result(reserved, sizeof(reserved)), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(next_result(indefinite, sizeof(indefinite)), OCRE_ERROR_INVALID);
+
+    // Lengths and counts beyond the input
+    static const uint8_t text_long[] = {0x65, 'a', 'b'};
+    static const uint8_t bytes_huge[] = {0x5b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+    static const uint8_t array_huge[] = {0x9b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+    static const uint8_t map_huge[] = {0xbb, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00};
+    static const uint8_t map_short[] = {0xa2, 0x61, 'a', 0x01};
+    OCRE_CHECK_EQ(next_result(text_long, sizeof(text_long)), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(next_result(bytes_huge, sizeof(bytes_huge)), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(skip_result(array_huge, sizeof(array_huge)), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(skip_result(map_huge, sizeof(map_huge)), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(skip_result(map_short, sizeof(map_short)), OCRE_ERROR_INVALID);
+
+    ocre_cbor_reader_t reader;
+    ocre_cbor_reader_t value;
+    ocre_cbor_reader_init(&reader, map_short, sizeof(map_short));
+    OCRE_CHECK_EQ(ocre_cbor_map_find(&reader, "b", &value), OCRE_ERROR_INVALID);
+
+    // Below INT64_MIN, and an unassigned simple value
+    static const uint8_t negint_huge[] = {0x3b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    static const uint8_t simple_unassigned[] = {0xe0};
+    OCRE_CHECK_EQ(next_result(negint_huge, sizeof(negint_huge)), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(next_result(simple_unassigned, sizeof(simple_unassigned)), OCRE_ERROR_INVALID);
+}
+
+static void test_deep_nesting(void)
+{
+    // Nesting far deeper than any recursive decoder's stack could take
+    static uint8_t buf[100001];
+    const size_t depth = sizeof(buf) - 1;
+
+    for (size_t i = 0; i < depth; i++)
+    {
+        buf[i] = (i & 1) ? 0xc1 : 0x81; // Alternate one-element arrays and tags
+    }
+    buf[depth] = 0x00;
+
+    ocre_cbor_reader_t reader;
+    ocre_cbor_reader_init(&reader, buf, sizeof(buf));
+    OCRE_CHECK_EQ(ocre_cbor_skip(&reader), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(reader.pos, sizeof(buf));
+
+    // The same nesting without its innermost item
+    ocre_cbor_reader_init(&reader, buf, depth);
+    OCRE_CHECK_EQ(ocre_cbor_skip(&reader), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(reader.pos, 0);
+}
+
+int main(void)
+{
+    test_int_round_trip();
+    test_float_round_trip();
+    test_container_round_trip();
+    test_writer_overflow();
+    test_malformed();
+    test_deep_nesting();
+    return ocre_test_failures ? 1 : 0;
+}
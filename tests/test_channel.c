@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_native.h"
+#include "ocre_test.h"
+#include <string.h>
+
+#define CAPACITY 4
+#define MSG_SIZE 8
+
+static ocre_channel_t producer;
+static ocre_channel_t consumer;
+
+static void open_pair(const char *name)
+{
+    OCRE_CHECK_EQ(ocre_channel_open(&producer, name, OCRE_CHANNEL_PRODUCER, CAPACITY, MSG_SIZE), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_channel_open(&consumer, name, OCRE_CHANNEL_CONSUMER, CAPACITY, MSG_SIZE), OCRE_SUCCESS);
+    OCRE_CHECK(producer.ring == consumer.ring);
+}
+
+static void close_pair(void)
+{
+    OCRE_CHECK_EQ(ocre_channel_close(&producer), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_channel_close(&consumer), OCRE_SUCCESS);
+}
+
+static void test_full_and_empty(void)
+{
+    uint8_t buf[MSG_SIZE];
+    const void *data;
+    uint32_t len;
+
+    open_pair("full");
+    OCRE_CHECK_EQ(ocre_channel_recv(&consumer, buf, sizeof(buf)), OCRE_ERROR_NOT_FOUND);
+    for (uint8_t i = 0; i < CAPACITY; i++)
+    {
+        OCRE_CHECK_EQ(ocre_channel_send(&producer, &i, 1), OCRE_SUCCESS);
+    }
+    OCRE_CHECK_EQ(ocre_channel_available(&producer), CAPACITY);
+    OCRE_CHECK_EQ(ocre_channel_send(&producer, "x", 1), OCRE_ERROR_BUSY);
+    OCRE_CHECK_EQ(ocre_channel_send(&producer, buf, MSG_SIZE + 1), OCRE_ERROR_INVALID);
+
+    // A buffer too small for the message leaves it in the ring
+    OCRE_CHECK_EQ(ocre_channel_recv(&consumer, buf, 0), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(ocre_channel_peek(&consumer, &data, &len), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(len, 1);
+    OCRE_CHECK_EQ(*(const uint8_t *)data, 0);
+    OCRE_CHECK_EQ(ocre_channel_consume(&consumer), OCRE_SUCCESS);
+
+    OCRE_CHECK_EQ(ocre_channel_send(&producer, "x", 1), OCRE_SUCCESS);
+    for (int i = 1; i < CAPACITY; i++)
+    {
+        OCRE_CHECK_EQ(ocre_channel_recv(&consumer, buf, sizeof(buf)), 1);
+        OCRE_CHECK_EQ(buf[0], i);
+    }
+    OCRE_CHECK_EQ(ocre_channel_recv(&consumer, buf, sizeof(buf)), 1);
+    OCRE_CHECK_EQ(buf[0], 'x');
+    OCRE_CHECK_EQ(ocre_channel_available(&consumer), 0);
+    close_pair();
+}
+
+// The indices run freely and wrap at 2^32; slots keep their order across the wrap
+static void test_index_wrap(void)
+{
+    uint8_t buf[MSG_SIZE];
+    uint32_t sent = 0;
+    uint32_t received = 0;
+
+    open_pair("wrap");
+    producer.ring->head = UINT32_MAX - 5;
+    consumer.ring->tail = UINT32_MAX - 5;
+
+    for (int round = 0; round < 6; round++)
+    {
+        for (int i = 0; i < 3; i++, sent++)
+        {
+            OCRE_CHECK_EQ(ocre_channel_send(&producer, &sent, sizeof(sent)), OCRE_SUCCESS);
+        }
+        OCRE_CHECK_EQ(ocre_channel_available(&consumer), 3);
+        for (int i = 0; i < 3; i++, received++)
+        {
+            uint32_t value;
+            OCRE_CHECK_EQ(ocre_channel_recv(&consumer, buf, sizeof(buf)), sizeof(value));
+            memcpy(&value, buf, sizeof(value));
+            OCRE_CHECK_EQ(value, received);
+        }
+    }
+    OCRE_CHECK(producer.ring->head < UINT32_MAX - 5);
+    OCRE_CHECK_EQ(producer.ring->head, producer.ring->tail);
+    close_pair();
+}
+
+// An idle consumer is signaled once by the next send, not once per message
+static void test_batched_wakeup(void)
+{
+    uint8_t buf[MSG_SIZE];
+
+    open_pair("wake");
+    int pending = ocre_native_pending_events();
+    OCRE_CHECK_EQ(ocre_channel_recv(&consumer, buf, sizeof(buf)), OCRE_ERROR_NOT_FOUND);
+    OCRE_CHECK_EQ(ocre_channel_send(&producer, "a", 1), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_channel_send(&producer, "b", 1), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_native_pending_events(), pending + 1);
+    close_pair();
+}
+
+int main(void)
+{
+    test_full_and_empty();
+    test_index_wrap();
+    test_batched_wakeup();
+    return ocre_test_failures ? 1 : 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_native.h"
+#include "ocre_test.h"
+#include <pthread.h>
+#include <string.h>
+
+#define RATE_HZ 10 // 100 ms between deliveries
+
+static pthread_t main_thread;
+static int received = 0;
+static uint32_t last_len = 0;
+static uint8_t last_payload[CONFIG_OCRE_MSG_LOAN_BUFFER_SIZE];
+
+static void filtered_handler(ocre_msg_t *msg)
+{
+    OCRE_CHECK(pthread_equal(pthread_self(), main_thread));
+    OCRE_CHECK(msg->payload_len <= sizeof(last_payload));
+    received++;
+    last_len = msg->payload_len;
+    memcpy(last_payload, msg->payload, msg->payload_len);
+}
+
+static void reset(void)
+{
+    ocre_messaging_cleanup_container(NULL);
+    received = 0;
+    last_len = 0;
+}
+
+static void wait_for(int count, uint32_t limit_ms)
+{
+    uint64_t start_ms = ocre_clock_monotonic_ms();
+    while (received < count && ocre_clock_monotonic_ms() - start_ms < limit_ms)
+    {
+        ocre_wait_events(10);
+    }
+}
+
+static void test_predicates(void)
+{
+    ocre_msg_filter_t filter;
+    uint8_t payload[] = {0x12, 0x34, 0x56, 0x78};
+    ocre_msg_t msg = {.topic = "t", .content_type = "application/octet-stream", .payload = payload,
+                      .payload_len = sizeof(payload)};
+
+    ocre_msg_filter_init(&filter);
+    OCRE_CHECK(ocre_msg_filter_match(&filter, &msg));
+    OCRE_CHECK_EQ(ocre_msg_filter_content_type(&filter, "application/octet-stream"), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_msg_filter_add_predicate(&filter, 0, 2, OCRE_MSG_PRED_EQ, 0x1234, UINT64_MAX), OCRE_SUCCESS);
+    OCRE_CHECK(ocre_msg_filter_match(&filter, &msg));
+    OCRE_CHECK_EQ(ocre_msg_filter_add_predicate(&filter, 2, 2, OCRE_MSG_PRED_GT | OCRE_MSG_PRED_LITTLE_ENDIAN,
+                                                0x7855, UINT64_MAX),
+                  OCRE_SUCCESS);
+    OCRE_CHECK(ocre_msg_filter_match(&filter, &msg));
+
+    payload[3] = 0x77; // Little-endian field is now 0x7756
+    OCRE_CHECK(!ocre_msg_filter_match(&filter, &msg));
+    payload[3] = 0x78;
+    msg.payload_len = 3; // Field beyond the payload
+    OCRE_CHECK(!ocre_msg_filter_match(&filter, &msg));
+    msg.payload_len = sizeof(payload);
+    msg.content_type = "text/plain";
+    OCRE_CHECK(!ocre_msg_filter_match(&filter, &msg));
+}
+
+static void subscribe_rate_limited(const char *topic, uint32_t flags)
+{
+    ocre_msg_filter_t filter;
+
+    ocre_msg_filter_init(&filter);
+    filter.max_rate_hz = RATE_HZ;
+    filter.flags = flags;
+    OCRE_CHECK_EQ(ocre_subscribe_message_filtered((char *)topic, "filtered_handler", &filter), OCRE_SUCCESS);
+}
+
+// Messages over the rate are dropped without OCRE_MSG_FILTER_LATEST_ONLY
+static void test_rate_limit_drops(void)
+{
+    reset();
+    subscribe_rate_limited("rate", 0);
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        OCRE_CHECK_EQ(ocre_publish_message("rate", "application/octet-stream", &i, 1), OCRE_SUCCESS);
+    }
+    OCRE_CHECK_EQ(received, 1);
+    OCRE_CHECK_EQ(last_payload[0], 0);
+
+    wait_for(2, 200);
+    OCRE_CHECK_EQ(received, 1);
+}
+
+// The newest message over the rate is delivered on the guest's thread once the interval ends
+static void test_latest_only(void)
+{
+    reset();
+    subscribe_rate_limited("latest", OCRE_MSG_FILTER_LATEST_ONLY);
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        OCRE_CHECK_EQ(ocre_publish_message("latest", "application/octet-stream", &i, 1), OCRE_SUCCESS);
+    }
+    OCRE_CHECK_EQ(received, 1);
+
+    wait_for(2, 1000);
+    OCRE_CHECK_EQ(received, 2);
+    OCRE_CHECK_EQ(last_payload[0], 4);
+}
+
+// A loaned payload larger than OCRE_MAX_PAYLOAD_LEN is held back and delivered intact
+static void test_latest_only_loaned(void)
+{
+    ocre_msg_loan_t loan;
+    uint32_t len = CONFIG_OCRE_MSG_LOAN_BUFFER_SIZE;
+
+    reset();
+    subscribe_rate_limited("loaned", OCRE_MSG_FILTER_LATEST_ONLY);
+    for (int i = 0; i < 2; i++)
+    {
+        OCRE_CHECK_EQ(ocre_msg_loan(len, &loan), OCRE_SUCCESS);
+        for (uint32_t j = 0; j < len; j++)
+        {
+            ((uint8_t *)loan.data)[j] = (uint8_t)(j + i);
+        }
+        OCRE_CHECK_EQ(ocre_msg_publish_loaned(&loan, "loaned", "application/octet-stream", len), OCRE_SUCCESS);
+    }
+    OCRE_CHECK_EQ(received, 1);
+
+    wait_for(2, 1000);
+    OCRE_CHECK_EQ(received, 2);
+    OCRE_CHECK_EQ(last_len, len);
+    for (uint32_t j = 0; j < len; j++)
+    {
+        if (last_payload[j] != (uint8_t)(j + 1))
+        {
+            fprintf(stderr, "held payload differs at byte %u\n", (unsigned)j);
+            ocre_test_failures++;
+            break;
+        }
+    }
+}
+
+int main(void)
+{
+    main_thread = pthread_self();
+    ocre_native_register_export("filtered_handler", filtered_handler);
+
+    test_predicates();
+    test_rate_limit_drops();
+    test_latest_only();
+    test_latest_only_loaned();
+    reset();
+    return ocre_test_failures ? 1 : 0;
+}
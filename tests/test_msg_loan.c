@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_native.h"
+#include "ocre_test.h"
+
+static ocre_msg_pool_t pool = {
+    .version = OCRE_MSG_POOL_VERSION,
+    .buffer_count = CONFIG_OCRE_MSG_LOAN_BUFFERS,
+    .buffer_size = CONFIG_OCRE_MSG_LOAN_BUFFER_SIZE,
+};
+
+static uint32_t kept[256];
+static int kept_count = 0;
+static int released_count = 0;
+
+static void releasing_handler(ocre_msg_t *msg)
+{
+    OCRE_CHECK_EQ(ocre_release_message(msg->mid), OCRE_SUCCESS);
+    released_count++;
+}
+
+static void keeping_handler(ocre_msg_t *msg)
+{
+    if (kept_count < (int)(sizeof(kept) / sizeof(kept[0])))
+    {
+        kept[kept_count] = msg->mid;
+    }
+    kept_count++;
+}
+
+static void reset(void)
+{
+    ocre_messaging_cleanup_container(NULL);
+    OCRE_CHECK_EQ(ocre_msg_pool_register(&pool), OCRE_SUCCESS);
+    for (uint32_t i = 0; i < CONFIG_OCRE_MSG_LOAN_BUFFERS; i++)
+    {
+        pool.refcount[i] = 0;
+    }
+    kept_count = 0;
+    released_count = 0;
+}
+
+// Each delivery holds one reference until its subscriber releases it, and releasing twice changes nothing
+static void test_delivery_refcounts(void)
+{
+    reset();
+    OCRE_CHECK_EQ(ocre_subscribe_message("loan", "releasing_handler"), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_subscribe_message("loan", "keeping_handler"), OCRE_SUCCESS);
+
+    pool.refcount[0] = 1; // The producer's loan
+    OCRE_CHECK_EQ(ocre_publish_message_loaned("loan", "text/plain", 0, 4), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(released_count, 1);
+    OCRE_CHECK_EQ(kept_count, 1);
+    OCRE_CHECK_EQ(pool.refcount[0], 2);
+
+    pool.refcount[0]--; // The producer hands its loan back after publishing
+    OCRE_CHECK_EQ(ocre_release_message(kept[0]), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(pool.refcount[0], 0);
+    OCRE_CHECK_EQ(ocre_release_message(kept[0]), OCRE_ERROR_NOT_FOUND);
+    OCRE_CHECK_EQ(pool.refcount[0], 0);
+}
+
+// A publish the runtime cannot track for every subscriber is delivered to none of them
+static void test_reference_table_full(void)
+{
+    int subscribers = 0;
+
+    reset();
+    while (ocre_subscribe_message("full", "keeping_handler") == OCRE_SUCCESS)
+    {
+        subscribers++;
+    }
+    OCRE_CHECK(subscribers > 1);
+
+    int published = 0;
+    int ret;
+    while ((ret = ocre_publish_message_loaned("full", "text/plain", 1, 4)) == OCRE_SUCCESS && published < 16)
+    {
+        published++;
+    }
+    OCRE_CHECK_EQ(ret, OCRE_ERROR_NO_MEMORY);
+    OCRE_CHECK(published > 0);
+    OCRE_CHECK_EQ(kept_count, published * subscribers);
+    OCRE_CHECK_EQ(pool.refcount[1], published * subscribers);
+
+    // One free reference is not enough for every subscriber
+    OCRE_CHECK_EQ(ocre_release_message(kept[0]), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_publish_message_loaned("full", "text/plain", 1, 4), OCRE_ERROR_NO_MEMORY);
+    OCRE_CHECK_EQ(kept_count, published * subscribers);
+    OCRE_CHECK_EQ(pool.refcount[1], published * subscribers - 1);
+}
+
+int main(void)
+{
+    ocre_native_register_export("releasing_handler", releasing_handler);
+    ocre_native_register_export("keeping_handler", keeping_handler);
+
+    test_delivery_refcounts();
+    test_reference_table_full();
+    ocre_messaging_cleanup_container(NULL);
+    return ocre_test_failures ? 1 : 0;
+}
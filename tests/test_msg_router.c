@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_native.h"
+#include "ocre_test.h"
+#include <string.h>
+
+static void count_handler(const ocre_msg_t *msg, void *user_ctx)
+{
+    (*(int *)user_ctx)++;
+}
+
+static int route(const char *filter, int *counter)
+{
+    int route_id = ocre_msg_route_add(filter, count_handler, counter);
+    OCRE_CHECK(route_id >= 0);
+    return route_id;
+}
+
+static int dispatch(const char *topic)
+{
+    ocre_msg_t msg = {.topic = (char *)topic, .content_type = "text/plain"};
+    return ocre_msg_route_dispatch(&msg);
+}
+
+static void test_wildcards(void)
+{
+    static const char *filters[] = {"a/b/c", "a/+/c", "a/#", "+/b/#", "#", "$SYS/#"};
+    int counts[sizeof(filters) / sizeof(filters[0])];
+    int ids[sizeof(filters) / sizeof(filters[0])];
+
+    memset(counts, 0, sizeof(counts));
+    for (size_t i = 0; i < sizeof(filters) / sizeof(filters[0]); i++)
+    {
+        ids[i] = route(filters[i], &counts[i]);
+    }
+
+    static const struct
+    {
+        const char *topic;
+        int matches[6]; // Per filter above
+    } cases[] = {
+        {"a/b/c", {1, 1, 1, 1, 1, 0}},
+        {"a/x/c", {0, 1, 1, 0, 1, 0}},
+        {"a/b", {0, 0, 1, 1, 1, 0}},
+        {"a", {0, 0, 1, 0, 1, 0}},
+        {"a/x/c/d", {0, 0, 1, 0, 1, 0}},
+        {"ab/b", {0, 0, 0, 1, 1, 0}},
+        {"$SYS/up", {0, 0, 0, 0, 0, 1}},
+        {"$SYS", {0, 0, 0, 0, 0, 1}},
+    };
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+    {
+        int expected = 0;
+        memset(counts, 0, sizeof(counts));
+        for (size_t i = 0; i < sizeof(filters) / sizeof(filters[0]); i++)
+        {
+            expected += cases[c].matches[i];
+        }
+
+        OCRE_CHECK_EQ(dispatch(cases[c].topic), expected);
+        for (size_t i = 0; i < sizeof(filters) / sizeof(filters[0]); i++)
+        {
+            if (counts[i] != cases[c].matches[i])
+            {
+                fprintf(stderr, "%s routed %d times to %s\n", cases[c].topic, counts[i], filters[i]);
+                ocre_test_failures++;
+            }
+        }
+    }
+
+    OCRE_CHECK_EQ(ocre_msg_route_add("a/b#", count_handler, NULL), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(ocre_msg_route_add("a/#/c", count_handler, NULL), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(ocre_msg_route_add("a+/b", count_handler, NULL), OCRE_ERROR_INVALID);
+
+    for (size_t i = 0; i < sizeof(filters) / sizeof(filters[0]); i++)
+    {
+        OCRE_CHECK_EQ(ocre_msg_route_remove(ids[i]), OCRE_SUCCESS);
+    }
+    OCRE_CHECK_EQ(dispatch("a/b/c"), 0);
+}
+
+static int publish_loaned(const char *topic)
+{
+    ocre_msg_loan_t loan;
+    int ret = ocre_msg_loan(8, &loan);
+    if (ret != OCRE_SUCCESS)
+    {
+        return ret;
+    }
+    memcpy(loan.data, "payload", 8);
+    return ocre_msg_publish_loaned(&loan, (char *)topic, "text/plain", 8);
+}
+
+// The router releases every loaned delivery once, whether it matched one route, several or none. Routes are added
+// narrowest first, so the runtime subscriptions to "net/dev/1" and then "net/dev/" are replaced by "net".
+static void test_loaned_release(void)
+{
+    int narrow = 0;
+    int device = 0;
+    int all = 0;
+    int ids[] = {route("net/dev/1", &narrow), route("net/dev/+", &device), route("net/#", &all)};
+
+    for (int i = 0; i < 4 * CONFIG_OCRE_MSG_LOAN_BUFFERS; i++)
+    {
+        OCRE_CHECK_EQ(publish_loaned("net/dev/1"), OCRE_SUCCESS);
+        OCRE_CHECK_EQ(publish_loaned("network"), OCRE_SUCCESS); // Reaches the router, matches no route
+    }
+    OCRE_CHECK_EQ(narrow, 4 * CONFIG_OCRE_MSG_LOAN_BUFFERS);
+    OCRE_CHECK_EQ(device, 4 * CONFIG_OCRE_MSG_LOAN_BUFFERS);
+    OCRE_CHECK_EQ(all, 4 * CONFIG_OCRE_MSG_LOAN_BUFFERS);
+
+    // Every buffer is back in the pool
+    ocre_msg_loan_t loans[CONFIG_OCRE_MSG_LOAN_BUFFERS];
+    for (int i = 0; i < CONFIG_OCRE_MSG_LOAN_BUFFERS; i++)
+    {
+        OCRE_CHECK_EQ(ocre_msg_loan(8, &loans[i]), OCRE_SUCCESS);
+    }
+    for (int i = 0; i < CONFIG_OCRE_MSG_LOAN_BUFFERS; i++)
+    {
+        ocre_msg_loan_cancel(&loans[i]);
+    }
+
+    for (size_t i = 0; i < sizeof(ids) / sizeof(ids[0]); i++)
+    {
+        OCRE_CHECK_EQ(ocre_msg_route_remove(ids[i]), OCRE_SUCCESS);
+    }
+}
+
+int main(void)
+{
+    test_loaned_release(); // First, while the runtime has no subscriptions
+    test_wildcards();
+    return ocre_test_failures ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include "ocre_test.h"
+
+#define BLOCK_COUNT 4
+#define BLOCK_SIZE 16
+
+static uint64_t storage[BLOCK_COUNT * BLOCK_SIZE / sizeof(uint64_t)];
+
+static void test_alloc_until_empty(void)
+{
+    ocre_pool_t pool;
+    ocre_pool_stats_t stats;
+    void *blocks[BLOCK_COUNT];
+    void *extra;
+
+    OCRE_CHECK_EQ(ocre_pool_init(&pool, storage, sizeof(storage), BLOCK_SIZE), OCRE_SUCCESS);
+    for (int i = 0; i < BLOCK_COUNT; i++)
+    {
+        OCRE_CHECK_EQ(ocre_pool_alloc(&pool, &blocks[i]), OCRE_SUCCESS);
+        OCRE_CHECK(ocre_pool_index(&pool, blocks[i]) >= 0);
+        for (int j = 0; j < i; j++)
+        {
+            OCRE_CHECK(blocks[i] != blocks[j]);
+        }
+    }
+    OCRE_CHECK_EQ(ocre_pool_alloc(&pool, &extra), OCRE_ERROR_NO_MEMORY);
+
+    OCRE_CHECK_EQ(ocre_pool_get_stats(&pool, &stats), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(stats.in_use, BLOCK_COUNT);
+    OCRE_CHECK_EQ(stats.high_water, BLOCK_COUNT);
+    OCRE_CHECK_EQ(stats.failures, 1);
+
+    OCRE_CHECK_EQ(ocre_pool_free(&pool, blocks[2]), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_pool_alloc(&pool, &extra), OCRE_SUCCESS);
+    OCRE_CHECK(extra == blocks[2]);
+}
+
+// Freeing a block twice, or a pointer that is not a block, is refused and leaves the free list intact
+static void test_double_free(void)
+{
+    ocre_pool_t pool;
+    ocre_pool_stats_t stats;
+    void *a;
+    void *b;
+    void *c;
+
+    OCRE_CHECK_EQ(ocre_pool_init(&pool, storage, sizeof(storage), BLOCK_SIZE), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_pool_alloc(&pool, &a), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_pool_alloc(&pool, &b), OCRE_SUCCESS);
+
+    OCRE_CHECK_EQ(ocre_pool_free(&pool, a), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_pool_free(&pool, a), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(ocre_pool_free(&pool, (uint8_t *)b + 1), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(ocre_pool_free(&pool, storage + sizeof(storage) / sizeof(storage[0])), OCRE_ERROR_INVALID);
+
+    OCRE_CHECK_EQ(ocre_pool_get_stats(&pool, &stats), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(stats.in_use, 1);
+
+    // A second free would have put the block on the list twice and handed it out twice
+    OCRE_CHECK_EQ(ocre_pool_alloc(&pool, &a), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_pool_alloc(&pool, &c), OCRE_SUCCESS);
+    OCRE_CHECK(a != c && a != b && c != b);
+}
+
+static void test_init_limits(void)
+{
+    static uint64_t large[(CONFIG_OCRE_POOL_MAX_BLOCKS + 1) * sizeof(void *) / sizeof(uint64_t) + 1];
+    ocre_pool_t pool;
+
+    OCRE_CHECK_EQ(ocre_pool_init(&pool, storage, sizeof(storage), 0), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(ocre_pool_init(&pool, storage, sizeof(storage), sizeof(void *) + 1), OCRE_ERROR_INVALID);
+    OCRE_CHECK_EQ(ocre_pool_init(&pool, large, sizeof(large), sizeof(void *)), OCRE_ERROR_INVALID);
+}
+
+int main(void)
+{
+    test_alloc_until_empty();
+    test_double_free();
+    test_init_limits();
+    return ocre_test_failures ? 1 : 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_api.h"
+#include "ocre_test.h"
+
+#define UNITS(x) ((ocre_sensor_value_t)((x) * OCRE_SENSOR_VALUE_SCALE))
+
+// Feed @p n copies of @p value and return how many results were emitted
+static int feed(ocre_sensor_agg_t *agg, ocre_sensor_value_t value, int n)
+{
+    static uint64_t timestamp_ns = 0;
+    int emitted = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        timestamp_ns += 1000000;
+        int ret = ocre_sensor_agg_add(agg, value, timestamp_ns);
+        OCRE_CHECK(ret >= 0);
+        emitted += ret > 0;
+    }
+    return emitted;
+}
+
+// A step beyond the deadband is reported once, not again while the sliding window catches up with it
+static void test_sliding_step_response(void)
+{
+    static ocre_sensor_agg_t agg;
+    ocre_sensor_agg_config_t config = {
+        .window_type = OCRE_SENSOR_AGG_SLIDING,
+        .window = 32,
+        .step = 32,
+        .stats = OCRE_SENSOR_AGG_ALL,
+        .deadband = UNITS(1.0),
+    };
+
+    OCRE_CHECK_EQ(ocre_sensor_agg_init(&agg, &config, NULL), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(feed(&agg, UNITS(20.0), 32), 1);
+    OCRE_CHECK_EQ(agg.result.mean, UNITS(20.0));
+
+    OCRE_CHECK_EQ(feed(&agg, UNITS(30.0), 32), 1);
+    OCRE_CHECK_EQ(agg.emitted, 2);
+    OCRE_CHECK_EQ(feed(&agg, UNITS(30.0), 64), 0);
+    OCRE_CHECK_EQ(agg.suppressed, 2);
+}
+
+// An early emit restarts the count towards the next sliding result
+static void test_sliding_early_emit_rearms(void)
+{
+    static ocre_sensor_agg_t agg;
+    ocre_sensor_agg_config_t config = {
+        .window_type = OCRE_SENSOR_AGG_SLIDING,
+        .window = 8,
+        .step = 4,
+        .stats = OCRE_SENSOR_AGG_MEAN,
+        .deadband = UNITS(1.0),
+    };
+
+    OCRE_CHECK_EQ(ocre_sensor_agg_init(&agg, &config, NULL), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(feed(&agg, UNITS(20.0), 8), 1);
+    OCRE_CHECK_EQ(feed(&agg, UNITS(20.0), 1), 0);
+    OCRE_CHECK_EQ(ocre_sensor_agg_add(&agg, UNITS(30.0), 0), 1);
+    OCRE_CHECK_EQ(agg.since_result, 0);
+    OCRE_CHECK_EQ(feed(&agg, UNITS(30.0), 4), 0);
+    OCRE_CHECK_EQ(agg.suppressed, 1);
+}
+
+static void test_tumbling_deadband(void)
+{
+    static ocre_sensor_agg_t agg;
+    ocre_sensor_agg_config_t config = {
+        .window_type = OCRE_SENSOR_AGG_TUMBLING,
+        .window = 4,
+        .stats = OCRE_SENSOR_AGG_MEAN,
+        .deadband = UNITS(1.0),
+    };
+
+    OCRE_CHECK_EQ(ocre_sensor_agg_init(&agg, &config, NULL), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(feed(&agg, UNITS(20.0), 4), 1);
+    OCRE_CHECK_EQ(feed(&agg, UNITS(20.5), 4), 0);
+    OCRE_CHECK_EQ(agg.suppressed, 1);
+
+    // The step emits the one-sample window at once, and the next window starts after it
+    OCRE_CHECK_EQ(feed(&agg, UNITS(25.0), 1), 1);
+    OCRE_CHECK_EQ(agg.result.count, 1);
+    OCRE_CHECK_EQ(feed(&agg, UNITS(25.0), 4), 0);
+    OCRE_CHECK_EQ(agg.suppressed, 2);
+
+    OCRE_CHECK_EQ(ocre_sensor_agg_flush(&agg), 0);
+    OCRE_CHECK_EQ(feed(&agg, UNITS(25.0), 1), 0);
+    OCRE_CHECK_EQ(ocre_sensor_agg_flush(&agg), 1);
+    OCRE_CHECK_EQ(agg.emitted, 3);
+}
+
+int main(void)
+{
+    test_sliding_step_response();
+    test_sliding_early_emit_rearms();
+    test_tumbling_deadband();
+    return ocre_test_failures ? 1 : 0;
+}
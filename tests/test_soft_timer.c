@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_native.h"
+#include "ocre_test.h"
+
+#define TIMER_COUNT 6
+
+static const uint32_t timeouts_ms[TIMER_COUNT] = {150, 3, 70, 20, 130, 64}; // 70 and up cascade from level 1
+static ocre_soft_timer_t timers[TIMER_COUNT];
+static uint64_t started_ms;
+static int order[TIMER_COUNT];
+static int fired = 0;
+
+static void on_expiry(ocre_soft_timer_t *timer, void *user_ctx)
+{
+    int index = (int)(intptr_t)user_ctx;
+    uint64_t elapsed_ms = ocre_clock_monotonic_ms() - started_ms;
+
+    if (elapsed_ms < timeouts_ms[index])
+    {
+        fprintf(stderr, "timer %d fired after %d ms, before its %d ms timeout\n", index, (int)elapsed_ms,
+                (int)timeouts_ms[index]);
+        ocre_test_failures++;
+    }
+    if (fired < TIMER_COUNT)
+    {
+        order[fired] = index;
+    }
+    fired++;
+}
+
+static void run_until(int expected, uint32_t limit_ms)
+{
+    while (fired < expected && ocre_clock_monotonic_ms() - started_ms < limit_ms)
+    {
+        ocre_process_events();
+    }
+}
+
+// Timers started out of order expire in deadline order, including those cascading down from the upper level
+static void test_expiry_order(void)
+{
+    started_ms = ocre_clock_monotonic_ms();
+    for (int i = 0; i < TIMER_COUNT; i++)
+    {
+        ocre_soft_timer_init(&timers[i], on_expiry, (void *)(intptr_t)i);
+        OCRE_CHECK_EQ(ocre_soft_timer_start(&timers[i], timeouts_ms[i], 0), OCRE_SUCCESS);
+    }
+
+    run_until(TIMER_COUNT, 1000);
+    OCRE_CHECK_EQ(fired, TIMER_COUNT);
+    for (int i = 1; i < TIMER_COUNT && i < fired; i++)
+    {
+        OCRE_CHECK(timeouts_ms[order[i - 1]] <= timeouts_ms[order[i]]);
+    }
+    for (int i = 0; i < TIMER_COUNT; i++)
+    {
+        OCRE_CHECK(!ocre_soft_timer_is_active(&timers[i]));
+    }
+}
+
+// A stopped timer never fires, and a periodic timer keeps its remaining time in range
+static void test_stop_and_period(void)
+{
+    fired = 0;
+    started_ms = ocre_clock_monotonic_ms();
+    ocre_soft_timer_init(&timers[0], on_expiry, (void *)(intptr_t)0);
+    ocre_soft_timer_init(&timers[1], on_expiry, (void *)(intptr_t)1);
+    OCRE_CHECK_EQ(ocre_soft_timer_start(&timers[0], timeouts_ms[0], 0), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_soft_timer_start(&timers[1], timeouts_ms[1], 10), OCRE_SUCCESS);
+    OCRE_CHECK(ocre_soft_timer_remaining(&timers[0]) <= timeouts_ms[0]);
+    OCRE_CHECK_EQ(ocre_soft_timer_stop(&timers[0]), OCRE_SUCCESS);
+    OCRE_CHECK(!ocre_soft_timer_is_active(&timers[0]));
+
+    run_until(5, 1000);
+    OCRE_CHECK_EQ(fired, 5);
+    OCRE_CHECK(ocre_soft_timer_is_active(&timers[1]));
+    OCRE_CHECK(ocre_soft_timer_remaining(&timers[1]) <= 10);
+    for (int i = 0; i < TIMER_COUNT && i < fired; i++)
+    {
+        OCRE_CHECK_EQ(order[i], 1);
+    }
+    OCRE_CHECK_EQ(ocre_soft_timer_stop(&timers[1]), OCRE_SUCCESS);
+}
+
+int main(void)
+{
+    test_expiry_order();
+    test_stop_and_period();
+    return ocre_test_failures ? 1 : 0;
+}
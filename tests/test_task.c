@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2025 Atym Incorporated. All rights reserved.
+ */
+#include "ocre_native.h"
+#include "ocre_test.h"
+#include <string.h>
+
+#define SENSOR_ID 3
+
+typedef struct
+{
+    int step;
+    int state;
+    bool timed_out;
+    int messages;
+} progress_t;
+
+static int sensor_task(ocre_task_t *task)
+{
+    progress_t *progress = task->user_ctx;
+
+    OCRE_TASK_BEGIN(task);
+    OCRE_TASK_AWAIT_SENSOR(task, SENSOR_ID, 0);
+    progress->state = task->event_state;
+    progress->step = 1;
+
+    OCRE_TASK_AWAIT_SENSOR(task, SENSOR_ID, 20);
+    progress->timed_out = task->timed_out;
+    progress->step = 2;
+    OCRE_TASK_END(task);
+}
+
+static int message_task(ocre_task_t *task)
+{
+    progress_t *progress = task->user_ctx;
+
+    OCRE_TASK_BEGIN(task);
+    OCRE_CHECK_EQ(ocre_task_subscribe(task, "task/in"), OCRE_SUCCESS);
+    OCRE_TASK_AWAIT_MESSAGE(task, 0);
+    progress->messages++;
+    progress->state = (int)task->msg->payload_len;
+
+    OCRE_TASK_SLEEP(task, 10); // Messages arriving now are dropped
+    progress->step = 1;
+
+    OCRE_TASK_AWAIT_MESSAGE(task, 0);
+    progress->messages++;
+    OCRE_TASK_END(task);
+}
+
+static int publish_loaned(const char *topic, uint32_t len)
+{
+    ocre_msg_loan_t loan;
+    int ret = ocre_msg_loan(len, &loan);
+    if (ret != OCRE_SUCCESS)
+    {
+        return ret;
+    }
+    memset(loan.data, 0, len);
+    return ocre_msg_publish_loaned(&loan, (char *)topic, "application/octet-stream", len);
+}
+
+static void run_until(const int *step, int target, uint32_t limit_ms)
+{
+    uint64_t start_ms = ocre_clock_monotonic_ms();
+    while (*step < target && ocre_clock_monotonic_ms() - start_ms < limit_ms)
+    {
+        ocre_process_events();
+    }
+}
+
+// A task wakes only for the event it awaits, gets its state, and times out when nothing arrives
+static void test_wait_and_notify(void)
+{
+    static ocre_task_t task;
+    progress_t progress = {0};
+
+    OCRE_CHECK_EQ(ocre_task_start(&task, sensor_task, &progress), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_task_start(&task, sensor_task, &progress), OCRE_ERROR_BUSY);
+    OCRE_CHECK_EQ(ocre_task_run(), 1);
+    OCRE_CHECK(!ocre_task_ready());
+
+    OCRE_CHECK_EQ(ocre_task_notify(OCRE_RESOURCE_TYPE_SENSOR, SENSOR_ID + 1, 0, 7), 0);
+    OCRE_CHECK_EQ(ocre_task_notify(OCRE_RESOURCE_TYPE_GPIO, SENSOR_ID, 0, 7), 0);
+    OCRE_CHECK_EQ(ocre_task_notify(OCRE_RESOURCE_TYPE_SENSOR, SENSOR_ID, 0, 42), 1);
+    OCRE_CHECK(ocre_task_ready());
+    OCRE_CHECK_EQ(ocre_task_run(), 1);
+    OCRE_CHECK_EQ(progress.step, 1);
+    OCRE_CHECK_EQ(progress.state, 42);
+
+    run_until(&progress.step, 2, 1000);
+    OCRE_CHECK_EQ(progress.step, 2);
+    OCRE_CHECK(progress.timed_out);
+    OCRE_CHECK(!ocre_task_ready());
+    OCRE_CHECK_EQ(ocre_task_stop(&task), OCRE_ERROR_NOT_FOUND);
+}
+
+// Messages resume a waiting task; those arriving while it is not waiting are dropped, and neither leaks its buffer
+static void test_messages(void)
+{
+    static ocre_task_t task;
+    progress_t progress = {0};
+
+    OCRE_CHECK_EQ(ocre_task_start(&task, message_task, &progress), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(ocre_task_run(), 1);
+
+    OCRE_CHECK_EQ(publish_loaned("task/in", 5), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(progress.messages, 1);
+    OCRE_CHECK_EQ(progress.state, 5);
+    for (int i = 0; i < 2 * CONFIG_OCRE_MSG_LOAN_BUFFERS; i++)
+    {
+        OCRE_CHECK_EQ(publish_loaned("task/in", 5), OCRE_SUCCESS);
+    }
+    OCRE_CHECK_EQ(progress.messages, 1);
+
+    run_until(&progress.step, 1, 1000);
+    OCRE_CHECK_EQ(progress.step, 1);
+    OCRE_CHECK_EQ(publish_loaned("task/in", 5), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(progress.messages, 2);
+
+    // The finished task's route is removed on the next scheduler pass
+    ocre_task_run();
+    OCRE_CHECK_EQ(publish_loaned("task/in", 5), OCRE_SUCCESS);
+    OCRE_CHECK_EQ(progress.messages, 2);
+}
+
+int main(void)
+{
+    test_wait_and_notify();
+    test_messages();
+    return ocre_test_failures ? 1 : 0;
+}